@@ -0,0 +1,268 @@
+#!/usr/bin/env python3
+"""Compile-time cost of the concept hierarchies in 00006, 00014 and 00018.
+
+    python3 bench/compile_time.py [--types 200] [--repeat 3] [--cxx g++]
+                                  [--json out.json] [--compare old.json]
+                                  [--tolerance 1.25] [--keep DIR]
+
+For every probe below a translation unit is generated that includes one
+submission and then checks one concept (or resolves one constrained
+call) for --types synthetic value and iterator types. Each unit is
+compiled --repeat times with -ftime-report, keeping the fastest run;
+the compiler's own TOTAL wall time, the template instantiation and
+constraint phases, the GGC total and the peak RSS of cc1plus are
+collected. The same file and types with no probe are the per-file
+baseline, so "us/type" is what checking one type costs on top of
+parsing the submission and the type itself.
+
+Probes with the same "kind" are different submissions' formulations of
+the same requirement, and are printed next to each other. With
+--compare, a probe whose us/type grew by more than --tolerance against
+an earlier --json report is listed and the exit status is 1.
+"""
+
+import argparse
+import json
+import os
+import re
+import subprocess
+import sys
+import tempfile
+
+ROOT = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+
+# Declared, never defined: only the front end runs.
+SYNTHETIC = """
+struct val{i} {{
+    int v;
+    bool operator<(const val{i}&) const;
+    bool operator==(const val{i}&) const;
+    bool operator!=(const val{i}&) const;
+}};
+struct iter{i} {{
+    using iterator_category = {tag};
+    using value_type = val{i};
+    using difference_type = std::ptrdiff_t;
+    using pointer = val{i}*;
+    using reference = val{i}&;
+    reference operator*() const;
+    pointer operator->() const;
+    iter{i}& operator++();
+    iter{i} operator++(int);
+    iter{i}& operator--();
+    iter{i} operator--(int);
+    iter{i}& operator+=(difference_type);
+    iter{i}& operator-=(difference_type);
+    iter{i} operator+(difference_type) const;
+    friend iter{i} operator+(difference_type, const iter{i}&);
+    iter{i} operator-(difference_type) const;
+    difference_type operator-(const iter{i}&) const;
+    reference operator[](difference_type) const;
+    bool operator<(const iter{i}&) const;
+    bool operator==(const iter{i}&) const;
+    bool operator!=(const iter{i}&) const;
+}};
+"""
+
+TAGS = ["std::input_iterator_tag", "std::forward_iterator_tag",
+        "std::bidirectional_iterator_tag", "std::random_access_iterator_tag"]
+
+# (file, kind, probe, per-type code)
+PROBES = [
+    ("00014", "char traits", "NarrowChar/WideChar (type_in_list)",
+     "static_assert(!CharType<val{i}> && !CharType<iter{i}>);"),
+    ("00014", "scalar traits", "Scalar/Object",
+     "static_assert(!Scalar<val{i}> && Object<val{i}>);"),
+    ("00014", "copy constructible", "DirectInitializable/CopyConstructible",
+     "static_assert(DirectInitializable<val{i}, const val{i}&> && "
+     "CopyConstructible<iter{i}>);"),
+    ("00014", "arrow", "op_arrow_detail::resolve_arrow",
+     "static_assert(SameType<op_arrow_detail::type<iter{i}>, val{i}*>);"),
+    ("00014", "input iterator", "InputIterator",
+     "static_assert(InputIterator<iter{i}>);"),
+    ("00014", "min call", "min(a, b)",
+     "inline void use{i}(const val{i}& a) {{ min(a, a); }}"),
+    ("00014", "for_each call", "for_each overloads",
+     "inline void use{i}(iter{i} f) {{ for_each(f, f, [](val{i}&) {{}}); }}"),
+
+    ("00018", "input iterator", "IteratorAtLeast",
+     "static_assert(concepts::IteratorAtLeast<iter{i}, "
+     "std::input_iterator_tag>);"),
+    ("00018", "range", "DenoteRange",
+     "static_assert(concepts::DenoteRange<std::input_iterator_tag, "
+     "iter{i}, iter{i}>);"),
+    ("00018", "min call", "min(a, b)",
+     "inline void use{i}(const val{i}& a) {{ min(a, a); }}"),
+    ("00018", "for_each call", "foo::for_each",
+     "inline void use{i}(iter{i} f) "
+     "{{ foo::for_each(f, f, [](val{i}&) {{}}); }}"),
+
+    ("00006", "copy constructible", "CopyConstructible",
+     "static_assert(CopyConstructible<val{i}> && "
+     "CopyConstructible<iter{i}>);"),
+    ("00006", "input iterator", "InputIterator",
+     "static_assert(InputIterator<iter{i}>);"),
+    ("00006", "min call", "min(a, b)",
+     "inline void use{i}(const val{i}& a) {{ min(a, a); }}"),
+    ("00006", "for_each call", "for_each (std::invoke)",
+     "inline void use{i}(iter{i} f) {{ for_each(f, f, [](val{i}&) {{}}); }}"),
+]
+
+PHASES = {
+    "TOTAL": "total_s",
+    "template instantiation": "instantiation_s",
+    "constraint satisfaction": "satisfaction_s",
+    "constraint normalization": "normalization_s",
+    "constraint subsumption": "subsumption_s",
+}
+
+UNITS = {"": 1.0 / 1024, "k": 1.0 / 1024, "M": 1.0, "G": 1024.0}
+
+
+def make_unit(file, body, types):
+    lines = ['#include "%s"' % os.path.join(ROOT, "concepts", file + ".cpp"),
+             "#include <cstddef>", "#include <iterator>"]
+    for i in range(types):
+        lines.append(SYNTHETIC.format(i=i, tag=TAGS[i % len(TAGS)]))
+        if body:
+            lines.append(body.format(i=i))
+    return "\n".join(lines) + "\n"
+
+
+def parse_time_report(text):
+    """Wall seconds per phase of interest, plus the GGC total in MB."""
+    out = {key: 0.0 for key in PHASES.values()}
+    out["ggc_mb"] = 0.0
+    for line in text.splitlines():
+        m = re.match(r"\s*([^:]+?)\s*:(.*)$", line)
+        if not m or m.group(1) not in PHASES:
+            continue
+        nums = re.findall(r"(\d+(?:\.\d+)?)\s*(?:\(\s*\d+%\))?", m.group(2))
+        if m.group(1) == "TOTAL":
+            # usr sys wall GGC
+            out["total_s"] = float(nums[2])
+            ggc = re.search(r"(\d+(?:\.\d+)?)([kMG]?)\s*$", m.group(2))
+            if ggc:
+                out["ggc_mb"] = float(ggc.group(1)) * UNITS[ggc.group(2)]
+        else:
+            # usr (%) sys (%) wall (%) GGC (%)
+            out[PHASES[m.group(1)]] = float(nums[2])
+    return out
+
+
+def compile_once(cxx, path):
+    cmd = [cxx, "-std=c++17", "-fconcepts-ts", "-fsyntax-only",
+           "-ftime-report", path]
+    proc = subprocess.Popen(cmd, stdout=subprocess.DEVNULL,
+                            stderr=subprocess.PIPE, text=True)
+    stderr = proc.stderr.read()
+    _, status, usage = os.wait4(proc.pid, 0)
+    proc.returncode = os.waitstatus_to_exitcode(status)
+    if proc.returncode != 0:
+        errors = [l for l in stderr.splitlines() if "error" in l]
+        raise RuntimeError("%s failed:\n%s" % (path, "\n".join(errors[:5])))
+    result = parse_time_report(stderr)
+    result["rss_mb"] = usage.ru_maxrss / 1024.0  # kB on Linux
+    return result
+
+
+def compile_unit(args, path):
+    runs = [compile_once(args.cxx, path) for _ in range(args.repeat)]
+    return min(runs, key=lambda r: r["total_s"])
+
+
+def run(args, workdir):
+    baselines = {}
+    for file in sorted({p[0] for p in PROBES}):
+        path = os.path.join(workdir, "%s_baseline.cpp" % file)
+        with open(path, "w") as f:
+            f.write(make_unit(file, None, args.types))
+        baselines[file] = compile_unit(args, path)
+
+    rows = []
+    for n, (file, kind, probe, body) in enumerate(PROBES):
+        path = os.path.join(workdir, "%s_probe%02d.cpp" % (file, n))
+        with open(path, "w") as f:
+            f.write(make_unit(file, body, args.types))
+        r = compile_unit(args, path)
+        base = baselines[file]
+        r.update(file=file, kind=kind, probe=probe, types=args.types,
+                 us_per_type=1e6 * (r["total_s"] - base["total_s"])
+                 / args.types)
+        rows.append(r)
+        print("%s %-40s %7.2f s" % (file, probe, r["total_s"]),
+              file=sys.stderr)
+    return baselines, rows
+
+
+def print_table(baselines, rows):
+    print("| kind | file | probe | total s | us/type | instantiation s "
+          "| constraints s | GGC MB | peak RSS MB |")
+    print("|---|---|---|---:|---:|---:|---:|---:|---:|")
+    for file, b in sorted(baselines.items()):
+        print("| (types only) | %s | | %.2f | | %.2f | %.2f | %.0f | %.0f |"
+              % (file, b["total_s"], b["instantiation_s"],
+                 b["satisfaction_s"] + b["normalization_s"]
+                 + b["subsumption_s"], b["ggc_mb"], b["rss_mb"]))
+    for r in sorted(rows, key=lambda r: (r["kind"], r["us_per_type"])):
+        print("| %s | %s | %s | %.2f | %.0f | %.2f | %.2f | %.0f | %.0f |"
+              % (r["kind"], r["file"], r["probe"], r["total_s"],
+                 r["us_per_type"], r["instantiation_s"],
+                 r["satisfaction_s"] + r["normalization_s"]
+                 + r["subsumption_s"], r["ggc_mb"], r["rss_mb"]))
+
+
+def compare(rows, path, tolerance, types):
+    with open(path) as f:
+        report = json.load(f)
+    if report["types"] != types:
+        sys.exit("%s was measured with --types %d" % (path, report["types"]))
+    old = {(r["file"], r["probe"]): r for r in report["probes"]}
+    regressions = 0
+    for r in rows:
+        o = old.get((r["file"], r["probe"]))
+        if not o:
+            continue
+        # The timer ticks in 10ms; ignore anything within a few ticks.
+        slower = r["total_s"] - o["total_s"] > 0.1
+        if slower and r["us_per_type"] > o["us_per_type"] * tolerance:
+            print("REGRESSION %s %s: %.0f us/type, was %.0f"
+                  % (r["file"], r["probe"], r["us_per_type"],
+                     o["us_per_type"]), file=sys.stderr)
+            regressions += 1
+    print("%d regression(s) against %s" % (regressions, path),
+          file=sys.stderr)
+    return regressions
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("--types", type=int, default=200)
+    parser.add_argument("--repeat", type=int, default=3)
+    parser.add_argument("--cxx", default=os.environ.get("CXX", "g++"))
+    parser.add_argument("--json")
+    parser.add_argument("--compare")
+    parser.add_argument("--tolerance", type=float, default=1.25)
+    parser.add_argument("--keep", help="write the generated units here")
+    args = parser.parse_args()
+
+    if args.keep:
+        os.makedirs(args.keep, exist_ok=True)
+        baselines, rows = run(args, args.keep)
+    else:
+        with tempfile.TemporaryDirectory() as workdir:
+            baselines, rows = run(args, workdir)
+
+    print_table(baselines, rows)
+    if args.json:
+        with open(args.json, "w") as f:
+            json.dump({"types": args.types, "baselines": baselines,
+                       "probes": rows}, f, indent=1)
+    if args.compare and compare(rows, args.compare, args.tolerance,
+                                args.types):
+        return 1
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
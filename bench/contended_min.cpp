@@ -0,0 +1,102 @@
+// 00014's fetch_min and sharded_min against a mutex, under contention.
+//
+//   g++ -std=c++20 -fconcepts-ts -O2 -pthread bench/contended_min.cpp
+//   ./a.out
+//
+// ns per update of a shared "lowest latency seen", from 1 to 64
+// threads, 2^21 updates in all. Random latencies soon stop improving
+// the minimum, so fetch_min mostly returns after its load; descending
+// ones improve it on every call, its worst case. Each variant's final
+// minimum is checked against the minimum of the same values computed
+// on one thread, and a mismatch makes the exit status 1. With fewer
+// cores than threads, the threads mostly take turns, and the numbers
+// say more about the cost of an update than about contention.
+
+#include "submissions.h"
+
+namespace {
+
+constexpr std::uint32_t updates = 1u << 21;
+
+// Thread t's i-th value.
+struct latencies {
+    bool descending;
+    std::uint32_t per_thread;
+
+    template <class F>
+    void run(unsigned t, F&& f) const
+    {
+        std::uint32_t seed = 7 + t;
+        for (std::uint32_t i = 0; i < per_thread; ++i) {
+            seed = seed * 1664525u + 1013904223u;
+            f(descending ? double(per_thread - i) + t / 64.0
+                         : double(seed >> 8));
+        }
+    }
+};
+
+template <class Update>
+double contended_ns(unsigned threads, const latencies& values, Update update)
+{
+    std::atomic<bool> go{ false };
+    std::vector<std::thread> workers;
+    for (unsigned t = 0; t < threads; ++t)
+        workers.emplace_back([&, t] {
+            while (!go.load()) std::this_thread::yield();
+            values.run(t, update);
+        });
+    const auto start = std::chrono::steady_clock::now();
+    go = true;
+    for (std::thread& w : workers) w.join();
+    const std::chrono::duration<double, std::nano> d =
+        std::chrono::steady_clock::now() - start;
+    return d.count() / (double(values.per_thread) * threads);
+}
+
+int mismatches = 0;
+
+void check(double got, double want, const char* what, bool descending,
+           unsigned threads)
+{
+    if (got == want) return;
+    std::fprintf(stderr, "MISMATCH %s %s x%u: %g, want %g\n", what,
+                 descending ? "descending" : "random", threads, got, want);
+    ++mismatches;
+}
+
+} // namespace
+
+int main()
+{
+    for (bool descending : { false, true }) {
+        for (unsigned threads = 1; threads <= 64; threads *= 2) {
+            const latencies values{ descending, updates / threads };
+            double want = std::numeric_limits<double>::infinity();
+            for (unsigned t = 0; t < threads; ++t)
+                values.run(t, [&want](double v) { want = std::min(want, v); });
+
+            std::mutex m;
+            double locked = std::numeric_limits<double>::infinity();
+            std::atomic<double> shared{ locked };
+            v14::sharded_min<double> sharded;
+            const double mutex_ns = contended_ns(threads, values,
+                [&](double v) {
+                    std::lock_guard<std::mutex> lock(m);
+                    if (v < locked) locked = v;
+                });
+            const double atomic_ns = contended_ns(threads, values,
+                [&](double v) { v14::fetch_min(shared, v); });
+            const double sharded_ns = contended_ns(threads, values,
+                [&](double v) { sharded.update(v); });
+            check(locked, want, "mutex", descending, threads);
+            check(shared.load(), want, "fetch_min", descending, threads);
+            check(sharded.load(), want, "sharded_min", descending, threads);
+            std::printf("%-10s x%-3u %7.2f ns/update  (mutex %7.2f, "
+                        "sharded %7.2f)\n",
+                        descending ? "descending" : "random", threads,
+                        atomic_ns, mutex_ns, sharded_ns);
+        }
+    }
+    std::fprintf(stderr, "%d mismatch(es)\n", mismatches);
+    return mismatches ? 1 : 0;
+}
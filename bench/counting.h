@@ -0,0 +1,175 @@
+// Copy, move and allocation counting for the bench drivers: a
+// CountingValue<T> that counts its copies and moves, global operator
+// new/delete replaced by counting ones, and contracts a measured
+// region is held to. Include it after submissions.h, in one
+// translation unit only, since it replaces operator new and delete.
+
+#ifndef BENCH_COUNTING_H
+#define BENCH_COUNTING_H
+
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include <string>
+#include <utility>
+
+// What a measured region did: heap allocations (and their bytes)
+// through the global operator new, and CountingValue copies and
+// moves. Relaxed atomics, because 00011 runs callables on its pool.
+struct tally {
+    long allocations = 0;
+    long bytes = 0;
+    long copies = 0;
+    long moves = 0;
+};
+
+struct counters {
+    std::atomic<long> allocations{ 0 };
+    std::atomic<long> bytes{ 0 };
+    std::atomic<long> copies{ 0 };
+    std::atomic<long> moves{ 0 };
+};
+
+inline counters counted;
+
+inline void bump(std::atomic<long>& c, long n = 1)
+{
+    c.fetch_add(n, std::memory_order_relaxed);
+}
+
+inline tally now()
+{
+    return { counted.allocations.load(std::memory_order_relaxed),
+             counted.bytes.load(std::memory_order_relaxed),
+             counted.copies.load(std::memory_order_relaxed),
+             counted.moves.load(std::memory_order_relaxed) };
+}
+
+inline tally operator-(const tally& a, const tally& b)
+{
+    return { a.allocations - b.allocations, a.bytes - b.bytes,
+             a.copies - b.copies, a.moves - b.moves };
+}
+
+// Counts for one run of f().
+template <class F>
+tally measure(F&& f)
+{
+    const tally before = now();
+    f();
+    return now() - before;
+}
+
+// A T that counts its copies and moves, and compares like T.
+template <class T>
+class CountingValue {
+public:
+    CountingValue() = default;
+    explicit CountingValue(T value) : value_(std::move(value)) {}
+
+    CountingValue(const CountingValue& other) : value_(other.value_)
+    { bump(counted.copies); }
+    CountingValue(CountingValue&& other) noexcept
+        : value_(std::move(other.value_))
+    { bump(counted.moves); }
+    CountingValue& operator=(const CountingValue& other)
+    {
+        value_ = other.value_;
+        bump(counted.copies);
+        return *this;
+    }
+    CountingValue& operator=(CountingValue&& other) noexcept
+    {
+        value_ = std::move(other.value_);
+        bump(counted.moves);
+        return *this;
+    }
+
+    const T& get() const { return value_; }
+
+    friend bool operator<(const CountingValue& a, const CountingValue& b)
+    { return a.value_ < b.value_; }
+    friend bool operator>(const CountingValue& a, const CountingValue& b)
+    { return b < a; }
+    friend bool operator<=(const CountingValue& a, const CountingValue& b)
+    { return !(b < a); }
+    friend bool operator>=(const CountingValue& a, const CountingValue& b)
+    { return !(a < b); }
+    friend bool operator==(const CountingValue& a, const CountingValue& b)
+    { return a.value_ == b.value_; }
+    friend bool operator!=(const CountingValue& a, const CountingValue& b)
+    { return !(a == b); }
+
+private:
+    T value_{};
+};
+
+// Contracts a call is held to, as a mask of what it may not do.
+enum contract : unsigned {
+    no_copies = 1,
+    no_moves = 2,
+    no_allocations = 4,
+    zero_cost = no_copies | no_moves | no_allocations,
+};
+
+inline int failures = 0;
+
+// Checks t against c, and reports and counts what it breaks. t may
+// be a difference from a reference tally, where fewer is no failure.
+inline bool expect(const tally& t, unsigned c, const std::string& what)
+{
+    bool ok = true;
+    auto check = [&](unsigned bit, long n, const char* noun) {
+        if (!(c & bit) || n <= 0) return;
+        std::fprintf(stderr, "FAIL %s: %ld %s\n", what.c_str(), n, noun);
+        ok = false;
+    };
+    check(no_copies, t.copies, "copies");
+    check(no_moves, t.moves, "moves");
+    check(no_allocations, t.allocations, "allocations");
+    if (!ok) ++failures;
+    return ok;
+}
+
+void* operator new(std::size_t n)
+{
+    bump(counted.allocations);
+    bump(counted.bytes, long(n));
+    if (void* p = std::malloc(n ? n : 1)) return p;
+    throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t n) { return ::operator new(n); }
+
+void* operator new(std::size_t n, std::align_val_t al)
+{
+    bump(counted.allocations);
+    bump(counted.bytes, long(n));
+    const std::size_t a = std::size_t(al);
+    if (void* p = std::aligned_alloc(a, (n + a - 1) / a * a)) return p;
+    throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t n, std::align_val_t al)
+{ return ::operator new(n, al); }
+
+// Every delete ends in one of the two below, like every new ends in
+// one of the two above. They stay out of line: inlined into a caller
+// that can see the operator new a pointer came from, their free()
+// looks like a mismatched pair to -Wmismatched-new-delete.
+[[gnu::noinline]] void operator delete(void* p) noexcept { std::free(p); }
+[[gnu::noinline]] void operator delete(void* p, std::align_val_t) noexcept
+{ std::free(p); }
+
+void operator delete[](void* p) noexcept { ::operator delete(p); }
+void operator delete(void* p, std::size_t) noexcept { ::operator delete(p); }
+void operator delete[](void* p, std::size_t) noexcept { ::operator delete(p); }
+void operator delete[](void* p, std::align_val_t al) noexcept
+{ ::operator delete(p, al); }
+void operator delete(void* p, std::size_t, std::align_val_t al) noexcept
+{ ::operator delete(p, al); }
+void operator delete[](void* p, std::size_t, std::align_val_t al) noexcept
+{ ::operator delete(p, al); }
+
+#endif // BENCH_COUNTING_H
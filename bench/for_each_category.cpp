@@ -0,0 +1,167 @@
+// 00014's for_each, per iterator category, against std::for_each.
+//
+//   g++ -std=c++20 -fconcepts-ts -O2 -pthread bench/for_each_category.cpp
+//   ./a.out
+//
+// The same 2^20 ints are walked through a raw pointer range, a
+// vector, a deque, a list and a forward_list, so that each of
+// 00014's for_each overloads (contiguous, random access,
+// bidirectional, forward) is timed next to std::for_each over the
+// same iterators. Times are ns/element, best of five runs of 20
+// passes. Both sums are checked against the element count, and a
+// mismatch makes the exit status 1.
+//
+// Then the prefetching for_each, which node iterators opt into by
+// specializing node_prefetch_distance: a forward_list of pointers to
+// 2^21 orders, one cache line each, where both the orders and the
+// list's own nodes are visited in shuffled memory order, so that
+// every node and every order is a miss the list walk alone would
+// wait out. It is timed
+// against std::for_each and against for_each_prefetch at other
+// distances, and the sums must agree.
+
+#include "submissions.h"
+
+namespace {
+
+int mismatches = 0;
+
+template <class Container>
+void row(const char* name, Container& c)
+{
+    const std::size_t n = std::distance(c.begin(), c.end());
+    auto time = [&](auto run) {
+        double best = 1e300;
+        for (int trial = 0; trial < 5; ++trial) {
+            const auto start = std::chrono::steady_clock::now();
+            for (int rep = 0; rep < 20; ++rep) run();
+            const std::chrono::duration<double, std::nano> d =
+                std::chrono::steady_clock::now() - start;
+            best = std::min(best, d.count() / (20.0 * n));
+        }
+        return best;
+    };
+    long ours_sum = 0, std_sum = 0;
+    const double ours = time([&] {
+        long sum = 0;
+        v14::for_each(c.begin(), c.end(), [&sum](int& x) { sum += x; });
+        ours_sum = sum;
+    });
+    const double theirs = time([&] {
+        long sum = 0;
+        std::for_each(c.begin(), c.end(), [&sum](int& x) { sum += x; });
+        std_sum = sum;
+    });
+    if (ours_sum != long(n) || std_sum != long(n)) {
+        std::fprintf(stderr, "MISMATCH %s: %ld, std %ld, want %zu\n", name,
+                     ours_sum, std_sum, n);
+        ++mismatches;
+    }
+    std::printf("%-14s %6.3f ns/elem  (std::for_each %6.3f)\n", name, ours,
+                theirs);
+}
+
+struct raw_range {
+    int* b;
+    int* e;
+    int* begin() const { return b; }
+    int* end() const { return e; }
+};
+
+struct order {
+    long amount;
+    char pad[56];
+};
+
+using order_list = std::forward_list<order*>;
+
+} // namespace
+
+// Opts order_list's iterator into 00014's prefetching for_each.
+template <>
+struct v14::node_prefetch_distance<order_list::iterator>
+    : std::integral_constant<std::ptrdiff_t, 8> {};
+
+namespace {
+
+static_assert(v14::PrefetchedNodeIterator<order_list::iterator>);
+
+template <class Walk>
+double prefetch_row(const char* name, order_list& lst, std::size_t n,
+                    long want, Walk walk)
+{
+    double best = 1e300;
+    for (int trial = 0; trial < 5; ++trial) {
+        long sum = 0;
+        auto add = [&sum](order* o) { sum += o->amount; };
+        const auto start = std::chrono::steady_clock::now();
+        walk(lst.begin(), lst.end(), add);
+        const std::chrono::duration<double, std::nano> d =
+            std::chrono::steady_clock::now() - start;
+        best = std::min(best, d.count() / n);
+        if (sum != want) {
+            std::fprintf(stderr, "MISMATCH %s: %ld, want %ld\n", name, sum,
+                         want);
+            ++mismatches;
+            break;
+        }
+    }
+    return best;
+}
+
+void prefetch_bench()
+{
+    const std::size_t n = 1 << 21;
+    std::vector<order> orders(n);
+    std::vector<order*> shuffled(n);
+    std::uint32_t seed = 5;
+    long want = 0;
+    for (std::size_t i = 0; i < n; ++i) {
+        seed = seed * 1664525u + 1013904223u;
+        orders[i].amount = seed >> 20;
+        want += orders[i].amount;
+        shuffled[i] = &orders[i];
+    }
+    std::mt19937 rng(5);
+    std::shuffle(shuffled.begin(), shuffled.end(), rng);
+    // Nodes are allocated in order, one per single-node list, then
+    // spliced together in another shuffled order, so that following
+    // the list jumps around memory like a long-lived list does.
+    std::vector<order_list> nodes(n);
+    for (std::size_t i = 0; i < n; ++i) nodes[i].push_front(shuffled[i]);
+    std::shuffle(nodes.begin(), nodes.end(), rng);
+    order_list lst;
+    for (order_list& node : nodes) lst.splice_after(lst.before_begin(), node);
+
+    using It = order_list::iterator;
+    const double plain = prefetch_row("std::for_each", lst, n, want,
+        [](It b, It e, auto f) { std::for_each(b, e, f); });
+    const double ours = prefetch_row("for_each", lst, n, want,
+        [](It b, It e, auto f) { v14::for_each(b, e, f); });
+    const double ahead2 = prefetch_row("for_each_prefetch<2>", lst, n, want,
+        [](It b, It e, auto f) { v14::for_each_prefetch<2>(b, e, f); });
+    const double ahead32 = prefetch_row("for_each_prefetch<32>", lst, n, want,
+        [](It b, It e, auto f) { v14::for_each_prefetch<32>(b, e, f); });
+    std::printf("%-14s %6.3f ns/elem  (std::for_each %6.3f, distance 2 "
+                "%6.3f, distance 32 %6.3f)\n",
+                "prefetched", ours, plain, ahead2, ahead32);
+}
+
+} // namespace
+
+int main()
+{
+    std::vector<int> vec(1 << 20, 1);
+    std::deque<int> deq(vec.begin(), vec.end());
+    std::list<int> lst(vec.begin(), vec.end());
+    std::forward_list<int> fwd(vec.begin(), vec.end());
+    raw_range raw{ vec.data(), vec.data() + vec.size() };
+    row("contiguous", raw);
+    row("vector", vec);
+    row("random-access", deq);
+    row("bidirectional", lst);
+    row("forward", fwd);
+    prefetch_bench();
+    std::fprintf(stderr, "%d mismatch(es)\n", mismatches);
+    return mismatches ? 1 : 0;
+}
@@ -0,0 +1,483 @@
+// Cross-implementation benchmark for the min/for_each submissions.
+//
+//   g++ -std=c++20 -fconcepts-ts -O2 -pthread bench/min_for_each.cpp
+//   ./a.out [--json out.json] [--baseline base.json] [--repeat 5]
+//           [--tolerance 1.5] [--min-ns 1] [--quick] [--no-counters]
+//
+// Every submission that g++ accepts is included into a namespace of
+// its own and measured next to std::min/std::for_each, over int,
+// double, std::string and 00014's MyData, at several sizes and input
+// orders. The whole sweep is run --repeat times, and each record is
+// the run with the median ratio to std. Results are written as JSON,
+// one record per line, in ns/element, as that ratio, and as the
+// highest ratio of any sweep.
+//
+// With --baseline, a record regresses when its ratio is above the
+// tolerance times the highest one the baseline saw, and it also got
+// slower by more than --min-ns ns/element than that ratio allows. The
+// 1-3 ns workloads move by more than 30% from run to run, but not by
+// a nanosecond; the ones that copy strings move by 50%, which is what
+// the baseline's highest ratio makes room for. Regressions are
+// reported and make the exit status 1. A baseline is only meaningful
+// on the machine that produced it, so none is kept in the tree: write
+// one there first with --json base.json.
+//
+// On Linux, every timed run is also counted with perf_event: cycles,
+// instructions, branch misses, L1D read misses and LLC misses. The
+// best run's counts are added to its record per element, with IPC,
+// and are what explains a ratio (00014's forward-iterator loop
+// against 00019's counted one, say). Counting needs
+// perf_event_paranoid <= 2 and a PMU the kernel exposes; without
+// them, or with --no-counters, each event that can't be opened is
+// reported once on stderr and left out of the records.
+//
+// Not included, because they are rejected before anything can be
+// measured: 00001-00005, 00007, 00013.
+
+#include "submissions.h"
+
+#ifdef __linux__
+#include <cerrno>
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+template <class T> struct type_name;
+template <> struct type_name<int> { static constexpr const char* value = "int"; };
+template <> struct type_name<double> { static constexpr const char* value = "double"; };
+template <> struct type_name<std::string> { static constexpr const char* value = "string"; };
+template <> struct type_name<MyData> { static constexpr const char* value = "MyData"; };
+
+template <class T> T make(std::uint32_t k);
+template <> int make<int>(std::uint32_t k) { return int(k); }
+template <> double make<double>(std::uint32_t k) { return k * 0.5; }
+template <> std::string make<std::string>(std::uint32_t k)
+{
+    // Long enough to defeat the small-string buffer, so copies show.
+    char buf[40];
+    std::snprintf(buf, sizeof buf, "key-%024u", unsigned(k));
+    return buf;
+}
+template <> MyData make<MyData>(std::uint32_t k)
+{ return MyData{ int(k), k * 0.25 }; }
+
+double key(int x) { return x; }
+double key(double x) { return x; }
+double key(const std::string& x) { return double(x.size() + x[4]); }
+double key(const MyData& x) { return x.n + x.z; }
+
+enum class dist { random, ascending, descending };
+const char* dist_name(dist d)
+{
+    switch (d) {
+    case dist::random: return "random";
+    case dist::ascending: return "ascending";
+    default: return "descending";
+    }
+}
+
+template <class T>
+std::vector<T> make_data(std::size_t n, dist d)
+{
+    std::vector<std::uint32_t> keys(n);
+    for (std::size_t i = 0; i < n; ++i) keys[i] = std::uint32_t(i);
+    if (d == dist::random) {
+        std::mt19937 gen(12345);
+        std::shuffle(keys.begin(), keys.end(), gen);
+    } else if (d == dist::descending) {
+        std::reverse(keys.begin(), keys.end());
+    }
+    std::vector<T> v;
+    v.reserve(n);
+    for (auto k : keys) v.push_back(make<T>(k));
+    return v;
+}
+
+volatile double sink;
+
+// Hardware counters for one measured region. Each event is opened on
+// its own rather than as a group, so that a PMU lacking one of them
+// still yields the rest; the kernel may then multiplex them, which
+// the enabled/running times scale back out.
+enum event { cycles, instructions, branch_misses, l1d_misses, llc_misses,
+             events };
+const char* const event_name[events] = {
+    "cycles", "instructions", "branch_misses", "l1d_misses", "llc_misses"
+};
+
+struct counts {
+    double value[events] = {};
+    bool valid[events] = {};
+};
+
+class counters {
+public:
+    counters() = default;
+    counters(const counters&) = delete;
+    counters& operator=(const counters&) = delete;
+    ~counters() { close(); }
+
+    // Returns whether at least one event could be opened.
+    bool open()
+    {
+#ifdef __linux__
+        const std::uint64_t cache_read_miss =
+            (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+            (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+        const std::pair<std::uint32_t, std::uint64_t> config[events] = {
+            { PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES },
+            { PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS },
+            { PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES },
+            { PERF_TYPE_HW_CACHE, PERF_COUNT_HW_CACHE_L1D | cache_read_miss },
+            { PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES },
+        };
+        bool any = false;
+        for (int e = 0; e < events; ++e) {
+            perf_event_attr attr;
+            std::memset(&attr, 0, sizeof attr);
+            attr.size = sizeof attr;
+            attr.type = config[e].first;
+            attr.config = config[e].second;
+            attr.disabled = 1;
+            // User space only: what perf_event_paranoid 2 still allows.
+            attr.exclude_kernel = 1;
+            attr.exclude_hv = 1;
+            attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED |
+                               PERF_FORMAT_TOTAL_TIME_RUNNING;
+            fd_[e] = int(syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+            if (fd_[e] < 0)
+                std::fprintf(stderr, "perf_event_open(%s): %s; not counted\n",
+                             event_name[e], std::strerror(errno));
+            else
+                any = true;
+        }
+        if (!any)
+            std::fprintf(stderr, "no hardware counters available; "
+                         "see /proc/sys/kernel/perf_event_paranoid\n");
+        return any;
+#else
+        std::fprintf(stderr, "hardware counters need Linux perf_event\n");
+        return false;
+#endif
+    }
+
+    void start()
+    {
+#ifdef __linux__
+        for (int fd : fd_) {
+            if (fd < 0) continue;
+            ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+            ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+        }
+#endif
+    }
+
+    counts stop()
+    {
+        counts c;
+#ifdef __linux__
+        for (int fd : fd_)
+            if (fd >= 0) ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+        for (int e = 0; e < events; ++e) {
+            std::uint64_t v[3]; // value, time enabled, time running
+            if (fd_[e] < 0 || read(fd_[e], v, sizeof v) != sizeof v ||
+                v[2] == 0)
+                continue;
+            c.value[e] = double(v[0]) * double(v[1]) / double(v[2]);
+            c.valid[e] = true;
+        }
+#endif
+        return c;
+    }
+
+    void close()
+    {
+#ifdef __linux__
+        for (int& fd : fd_) {
+            if (fd >= 0) ::close(fd);
+            fd = -1;
+        }
+#endif
+    }
+
+private:
+    int fd_[events] = { -1, -1, -1, -1, -1 };
+};
+
+counters pmu;
+
+// Best of a few runs, each long enough to be above timer noise. The
+// best run's counter values, per element, go to *per_element.
+template <class Run>
+double ns_per_element(std::size_t n, std::size_t budget, Run run,
+                      counts* per_element)
+{
+    const std::size_t reps = std::max<std::size_t>(1, budget / n);
+    double best = std::numeric_limits<double>::infinity();
+    for (int trial = 0; trial < 7; ++trial) {
+        pmu.start();
+        auto start = std::chrono::steady_clock::now();
+        for (std::size_t r = 0; r < reps; ++r) run();
+        std::chrono::duration<double, std::nano> d =
+            std::chrono::steady_clock::now() - start;
+        counts c = pmu.stop();
+        const double ns = d.count() / double(reps * n);
+        if (ns < best) {
+            best = ns;
+            for (double& v : c.value) v /= double(reps * n);
+            *per_element = c;
+        }
+    }
+    return best;
+}
+
+struct record {
+    std::string impl, op, type, dist;
+    std::size_t size;
+    double ns;
+    counts per_element; // hardware counters, per element
+    double vs_std = 1; // ns over std's ns for the same workload
+    double vs_std_max = 1; // the highest vs_std of the sweeps
+
+    std::string workload() const
+    {
+        return op + "/" + type + "/" + std::to_string(size) + "/" + dist;
+    }
+    std::string id() const { return impl + "/" + workload(); }
+};
+
+std::vector<record> results;
+std::size_t budget = 2000000;
+
+// The running minimum is kept by value so that every implementation
+// pays for the same assignment; what differs is what min itself
+// copies on the way.
+template <class Impl, class T>
+void bench_min(const std::vector<T>& v, dist d)
+{
+    if constexpr (requires (const T& a) { Impl::min(a, a); }) {
+        counts c;
+        double ns = ns_per_element(v.size(), budget, [&] {
+            T acc = v[0];
+            for (std::size_t i = 1; i < v.size(); ++i)
+                acc = Impl::min(acc, v[i]);
+            sink = key(acc);
+        }, &c);
+        results.push_back({ Impl::name, "min", type_name<T>::value,
+                            dist_name(d), v.size(), ns, c });
+    }
+}
+
+template <class Impl, class T>
+void bench_for_each(std::vector<T>& v, dist d)
+{
+    using I = typename std::vector<T>::iterator;
+    auto f = [](const T&) {};
+    if constexpr (requires (I i) { Impl::for_each(i, i, f); }) {
+        counts c;
+        double ns = ns_per_element(v.size(), budget, [&] {
+            double acc = 0;
+            Impl::for_each(v.begin(), v.end(),
+                           [&acc](const T& x) { acc += key(x); });
+            sink = acc;
+        }, &c);
+        results.push_back({ Impl::name, "for_each", type_name<T>::value,
+                            dist_name(d), v.size(), ns, c });
+    }
+}
+
+template <class T, class... Impls>
+void bench_type(const std::vector<std::size_t>& sizes)
+{
+    for (std::size_t n : sizes) {
+        for (dist d : { dist::random, dist::ascending, dist::descending }) {
+            auto v = make_data<T>(n, d);
+            (bench_min<Impls>(v, d), ...);
+            (bench_for_each<Impls>(v, d), ...);
+        }
+    }
+}
+
+template <class T>
+void bench_all(const std::vector<std::size_t>& sizes)
+{
+    bench_type<T, std_impl, v06_impl, v08_impl, v09_impl, v10_impl,
+               v11_impl, v12_impl, v14_impl, v15_impl, v16_impl,
+               v17_impl, v18_impl, v19_impl, v20_impl>(sizes);
+}
+
+// Timings on a shared machine drift together, so regressions are
+// judged on each implementation's ratio to std from the same run.
+void relate_to_std()
+{
+    std::map<std::string, double> std_ns;
+    for (const record& r : results)
+        if (r.impl == "std") std_ns[r.workload()] = r.ns;
+    for (record& r : results)
+        r.vs_std = r.ns / std_ns.at(r.workload());
+}
+
+// Every sweep produces its records in the same order. Each record is
+// taken from the sweep with the median ratio (and, for std's own
+// records, the median time), so that one sweep disturbed by another
+// process is outvoted by the rest, and keeps the highest ratio as a
+// measure of how much it moves.
+std::vector<record> median_of(std::vector<std::vector<record>>& sweeps)
+{
+    std::vector<record> merged;
+    for (std::size_t i = 0; i < sweeps[0].size(); ++i) {
+        std::vector<const record*> runs;
+        for (const auto& sweep : sweeps) runs.push_back(&sweep[i]);
+        const auto mid = runs.begin() + runs.size() / 2;
+        std::nth_element(runs.begin(), mid, runs.end(),
+                         [](const record* a, const record* b) {
+                             return a->vs_std < b->vs_std ||
+                                    (a->vs_std == b->vs_std && a->ns < b->ns);
+                         });
+        merged.push_back(**mid);
+        for (const record* r : runs)
+            merged.back().vs_std_max =
+                std::max(merged.back().vs_std_max, r->vs_std);
+    }
+    return merged;
+}
+
+// Counter fields follow vs_std, so read_baseline's fixed prefix
+// matches records with and without them.
+void write_json(std::FILE* out)
+{
+    std::fprintf(out, "{\"results\": [\n");
+    for (std::size_t i = 0; i < results.size(); ++i) {
+        const record& r = results[i];
+        const counts& c = r.per_element;
+        std::fprintf(out,
+            "  {\"impl\": \"%s\", \"op\": \"%s\", \"type\": \"%s\", "
+            "\"size\": %zu, \"dist\": \"%s\", \"ns_per_elem\": %.4f, "
+            "\"vs_std\": %.3f, \"vs_std_max\": %.3f",
+            r.impl.c_str(), r.op.c_str(), r.type.c_str(), r.size,
+            r.dist.c_str(), r.ns, r.vs_std, r.vs_std_max);
+        for (int e = 0; e < events; ++e)
+            if (c.valid[e])
+                std::fprintf(out, ", \"%s_per_elem\": %.4f",
+                             event_name[e], c.value[e]);
+        if (c.valid[cycles] && c.valid[instructions] && c.value[cycles] > 0)
+            std::fprintf(out, ", \"ipc\": %.3f",
+                         c.value[instructions] / c.value[cycles]);
+        std::fprintf(out, "}%s\n", i + 1 < results.size() ? "," : "");
+    }
+    std::fprintf(out, "]}\n");
+}
+
+// Reads back the highest ratios of what write_json produces, one
+// record per line; vs_std where a record has no vs_std_max.
+std::map<std::string, double> read_baseline(const char* path)
+{
+    std::map<std::string, double> base;
+    std::FILE* in = std::fopen(path, "r");
+    if (!in) {
+        std::fprintf(stderr, "cannot open baseline %s\n", path);
+        std::exit(2);
+    }
+    char line[512];
+    while (std::fgets(line, sizeof line, in)) {
+        char impl[32], op[32], type[32], d[32];
+        std::size_t size;
+        double ns, ratio, highest;
+        const int n = std::sscanf(line,
+                " {\"impl\": \"%31[^\"]\", \"op\": \"%31[^\"]\", "
+                "\"type\": \"%31[^\"]\", \"size\": %zu, "
+                "\"dist\": \"%31[^\"]\", \"ns_per_elem\": %lf, "
+                "\"vs_std\": %lf, \"vs_std_max\": %lf",
+                impl, op, type, &size, d, &ns, &ratio, &highest);
+        if (n < 7) continue;
+        if (n == 7) highest = ratio;
+        base[record{ impl, op, type, d, size, ns, {}, ratio, highest }.id()] =
+            highest;
+    }
+    std::fclose(in);
+    return base;
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    const char* json_path = nullptr;
+    const char* baseline_path = nullptr;
+    double tolerance = 1.5;
+    double min_ns = 1;
+    int repeat = 5;
+    bool count = true;
+    std::vector<std::size_t> sizes{ 1000, 100000, 1000000 };
+    for (int i = 1; i < argc; ++i) {
+        if (!std::strcmp(argv[i], "--json") && i + 1 < argc)
+            json_path = argv[++i];
+        else if (!std::strcmp(argv[i], "--baseline") && i + 1 < argc)
+            baseline_path = argv[++i];
+        else if (!std::strcmp(argv[i], "--tolerance") && i + 1 < argc)
+            tolerance = std::atof(argv[++i]);
+        else if (!std::strcmp(argv[i], "--min-ns") && i + 1 < argc)
+            min_ns = std::atof(argv[++i]);
+        else if (!std::strcmp(argv[i], "--repeat") && i + 1 < argc)
+            repeat = std::max(1, std::atoi(argv[++i]));
+        else if (!std::strcmp(argv[i], "--quick")) {
+            sizes = { 1000, 100000 };
+            budget /= 10;
+        } else if (!std::strcmp(argv[i], "--no-counters")) {
+            count = false;
+        } else {
+            std::fprintf(stderr, "unknown argument %s\n", argv[i]);
+            return 2;
+        }
+    }
+
+    if (count) pmu.open();
+
+    std::vector<std::vector<record>> sweeps;
+    for (int i = 0; i < repeat; ++i) {
+        results.clear();
+        bench_all<int>(sizes);
+        bench_all<double>(sizes);
+        bench_all<std::string>(sizes);
+        bench_all<MyData>(sizes);
+        relate_to_std();
+        sweeps.push_back(std::move(results));
+    }
+    results = median_of(sweeps);
+
+    if (json_path) {
+        std::FILE* out = std::fopen(json_path, "w");
+        if (!out) {
+            std::fprintf(stderr, "cannot write %s\n", json_path);
+            return 2;
+        }
+        write_json(out);
+        std::fclose(out);
+    } else {
+        write_json(stdout);
+    }
+
+    if (!baseline_path) return 0;
+    const auto base = read_baseline(baseline_path);
+    int regressions = 0;
+    for (const record& r : results) {
+        auto it = base.find(r.id());
+        if (it == base.end() || r.vs_std <= it->second * tolerance)
+            continue;
+        // What std's time today and the baseline's ratio allow.
+        const double allowed_ns = r.ns / r.vs_std * it->second;
+        if (r.ns - allowed_ns <= min_ns) continue;
+        std::fprintf(stderr,
+                     "REGRESSION %s: %.3fx std, baseline up to %.3fx "
+                     "(%.4f ns/elem)\n",
+                     r.id().c_str(), r.vs_std, it->second, r.ns);
+        ++regressions;
+    }
+    std::fprintf(stderr, "%d regression(s) against %s\n",
+                 regressions, baseline_path);
+    return regressions ? 1 : 0;
+}
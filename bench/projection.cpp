@@ -0,0 +1,188 @@
+// The projection overloads of min, min_element and for_each in 00012
+// and 00014 against std::min_element with a hand-written comparator.
+//
+//   g++ -std=c++20 -fconcepts-ts -O2 -pthread bench/projection.cpp
+//   ./a.out
+//
+// First every overload is checked on a few contacts: by a data
+// member, a member function and a lambda, over a range, an
+// initializer_list and an empty range, and with equal keys, where the
+// first element must win. cache_keys must give the same answers while
+// computing each key once. Then 2^16 contacts are searched by a key
+// that allocates (longer than the small-string buffer) and by a
+// member int: the comparator, the projection, and the projection with
+// cache_keys, in ns/element, best of five runs. Every timed answer is
+// checked against std::min_element too, and a mismatch makes the exit
+// status 1.
+
+#include "submissions.h"
+
+namespace {
+
+struct contact {
+    std::string given, family;
+    int age;
+    std::string sort_key() const { return family + ", " + given; }
+};
+
+int mismatches = 0;
+
+void expect(bool ok, const char* ns, const char* what)
+{
+    if (ok) return;
+    std::fprintf(stderr, "MISMATCH %s %s\n", ns, what);
+    ++mismatches;
+}
+
+const auto less = [](const auto& a, const auto& b) { return a < b; };
+const auto greater = [](const auto& a, const auto& b) { return b < a; };
+
+#define PROJECTION_IMPL(ns, label)                                     \
+    struct ns##_proj {                                                 \
+        static constexpr const char* name = label;                    \
+        template <class R, class C, class P>                           \
+        static auto min(R&& r, C comp, P proj)                         \
+        { return ns::min(std::forward<R>(r), comp, proj); }            \
+        template <class T, class C, class P>                           \
+        static T min(std::initializer_list<T> il, C comp, P proj)      \
+        { return ns::min(il, comp, proj); }                            \
+        template <class I, class C, class P>                           \
+        static I min_element(I b, I e, C comp, P proj)                 \
+        { return ns::min_element(b, e, comp, proj); }                  \
+        template <class I, class F, class P>                           \
+        static void for_each(I b, I e, F f, P proj)                    \
+        { ns::for_each(b, e, f, proj); }                               \
+        template <class P>                                             \
+        static auto cache_keys(P proj) { return ns::cache_keys(proj); }\
+    };
+
+PROJECTION_IMPL(v12, "00012")
+PROJECTION_IMPL(v14, "00014")
+#undef PROJECTION_IMPL
+
+template <class Impl>
+void check()
+{
+    const char* ns = Impl::name;
+    std::vector<contact> cs = {
+        { "ada", "lovelace", 36 }, { "alan", "turing", 41 },
+        { "grace", "hopper", 85 }, { "edsger", "dijkstra", 72 },
+        { "barbara", "liskov", 36 },
+    };
+    const auto b = cs.begin(), e = cs.end();
+
+    expect(Impl::min_element(b, e, less, &contact::age) == b, ns,
+           "min_element by data member, first of equal keys");
+    expect(Impl::min_element(b, e, greater, &contact::age) == b + 2, ns,
+           "min_element with greater");
+    expect(Impl::min_element(b, e, less, &contact::sort_key) == b + 3, ns,
+           "min_element by member function");
+    expect(Impl::min_element(b, e, less,
+                             [](const contact& c) { return c.given; }) == b,
+           ns, "min_element by lambda");
+    expect(Impl::min_element(b, b, less, &contact::age) == b, ns,
+           "min_element of an empty range");
+
+    // n keys with cache_keys, against two for each of n-1 comparisons.
+    int calls = 0;
+    auto counted = [&calls](const contact& c) {
+        ++calls;
+        return c.sort_key();
+    };
+    expect(Impl::min_element(b, e, less, counted) == b + 3 &&
+               calls == 2 * (int(cs.size()) - 1),
+           ns, "min_element projects both sides");
+    calls = 0;
+    expect(Impl::min_element(b, e, less, Impl::cache_keys(counted)) ==
+                   b + 3 && calls == int(cs.size()),
+           ns, "min_element with cache_keys projects each element once");
+    expect(Impl::min_element(b, e, less, Impl::cache_keys(&contact::age)) == b,
+           ns, "cache_keys, first of equal keys");
+
+    expect(Impl::min(cs, less, &contact::sort_key).family == "dijkstra", ns,
+           "min of a range by member function");
+    expect(Impl::min(cs, greater, &contact::age).given == "grace", ns,
+           "min of a range with greater");
+    expect(Impl::min({ 3, -7, 5, -7 }, less,
+                     [](int x) { return x * x; }) == 3, ns,
+           "min of an initializer_list by lambda");
+
+    int total = 0;
+    Impl::for_each(b, e, [&total](int age) { total += age; }, &contact::age);
+    expect(total == 36 + 41 + 85 + 72 + 36, ns, "for_each by data member");
+    std::string initials;
+    Impl::for_each(b, e, [&initials](const std::string& k) {
+        initials += k[0];
+    }, &contact::sort_key);
+    expect(initials == "lthdl", ns, "for_each by member function");
+}
+
+// Not const: 00014's InputIterator wants operator-> to yield a
+// value_type*, which a const_iterator over a class does not.
+template <class Impl>
+void bench(std::vector<contact>& cs)
+{
+    auto time = [&](auto run) {
+        double best = 1e300;
+        for (int trial = 0; trial < 5; ++trial) {
+            const auto start = std::chrono::steady_clock::now();
+            run();
+            const std::chrono::duration<double, std::nano> d =
+                std::chrono::steady_clock::now() - start;
+            best = std::min(best, d.count() / cs.size());
+        }
+        return best;
+    };
+    auto row = [&](const char* key, auto comparator, auto proj) {
+        // std::min_element and the projection both return the first
+        // of the least keys, so the answers must be the same element.
+        std::ptrdiff_t want = 0, projected = 0, cached = 0;
+        const double comparator_ns = time([&] {
+            want = std::min_element(cs.begin(), cs.end(), comparator) -
+                   cs.begin();
+        });
+        const double projected_ns = time([&] {
+            projected = Impl::min_element(cs.begin(), cs.end(), less, proj) -
+                        cs.begin();
+        });
+        const double cached_ns = time([&] {
+            cached = Impl::min_element(cs.begin(), cs.end(), less,
+                                       Impl::cache_keys(proj)) -
+                     cs.begin();
+        });
+        expect(projected == want && cached == want, Impl::name, key);
+        std::printf("%s %-12s %7.3f ns/elem  (comparator %7.3f, "
+                    "cache_keys %7.3f)  %td\n",
+                    Impl::name, key, projected_ns, comparator_ns, cached_ns,
+                    want);
+    };
+    row("key string",
+        [](const contact& a, const contact& b) {
+            return a.sort_key() < b.sort_key();
+        },
+        &contact::sort_key);
+    row("member int",
+        [](const contact& a, const contact& b) { return a.age < b.age; },
+        &contact::age);
+}
+
+} // namespace
+
+int main()
+{
+    check<v12_proj>();
+    check<v14_proj>();
+
+    std::uint32_t seed = 17;
+    auto rng = [&seed] { return (seed = seed * 1664525u + 1013904223u) >> 8; };
+    std::vector<contact> cs(1 << 16);
+    for (auto& c : cs) {
+        c.given = "given-name-" + std::to_string(rng() % 1000);
+        c.family = "family-name-" + std::to_string(rng() % 1000);
+        c.age = int(rng() % 100);
+    }
+    bench<v14_proj>(cs);
+    bench<v12_proj>(cs);
+    std::fprintf(stderr, "%d mismatch(es)\n", mismatches);
+    return mismatches ? 1 : 0;
+}
@@ -0,0 +1,159 @@
+// 00010's sliding_min against recomputing the min of every window.
+//
+//   g++ -std=c++20 -fconcepts-ts -O2 -pthread bench/sliding_min.cpp
+//   ./a.out
+//
+// A stream of doubles, in random, ascending and descending order, is
+// fed through windows of several widths, in two shapes:
+//
+//  - per sample: the window's min after every sample, as a monitor
+//    wants it. sliding_min::push_range(first, last, out) against
+//    std::min_element over each window, and against 00014's
+//    vectorized min_element over each window.
+//  - per batch: the min after each batch of samples only.
+//    sliding_min::push_range(first, last) against push() of every
+//    sample, and against one recompute over the window per batch.
+//
+// Times are ns/sample, best of three runs. Every answer is checked
+// against the recomputed one, and a mismatch makes the exit status 1.
+// 00010's own sliding_min_tests() run first; they assert, so build
+// without NDEBUG.
+
+#include "submissions.h"
+
+namespace {
+
+enum class dist { random, ascending, descending };
+const char* dist_name(dist d)
+{
+    switch (d) {
+    case dist::random: return "random";
+    case dist::ascending: return "ascending";
+    default: return "descending";
+    }
+}
+
+std::vector<double> make_stream(std::size_t n, dist d)
+{
+    std::vector<double> v(n);
+    std::uint32_t seed = 12345;
+    for (std::size_t i = 0; i < n; ++i) {
+        seed = seed * 1664525u + 1013904223u;
+        v[i] = d == dist::random ? double(seed >> 8)
+             : d == dist::ascending ? double(i) : double(n - i);
+    }
+    return v;
+}
+
+template <class F>
+double ns_per_sample(std::size_t n, F&& run)
+{
+    double best = 1e300;
+    for (int trial = 0; trial < 3; ++trial) {
+        const auto start = std::chrono::steady_clock::now();
+        run();
+        const std::chrono::duration<double, std::nano> d =
+            std::chrono::steady_clock::now() - start;
+        best = std::min(best, d.count() / double(n));
+    }
+    return best;
+}
+
+int mismatches = 0;
+
+void check(const std::vector<double>& got, const std::vector<double>& want,
+           const char* what, std::size_t window, dist d)
+{
+    if (got == want) return;
+    std::fprintf(stderr, "MISMATCH %s window %zu %s\n", what, window,
+                 dist_name(d));
+    ++mismatches;
+}
+
+// The first sample of the window ending at i.
+std::size_t window_start(std::size_t i, std::size_t window)
+{
+    return i + 1 > window ? i + 1 - window : 0;
+}
+
+void per_sample(const std::vector<double>& x, std::size_t window, dist d)
+{
+    const std::size_t n = x.size();
+    std::vector<double> want(n), got(n);
+
+    const double recompute = ns_per_sample(n, [&] {
+        for (std::size_t i = 0; i < n; ++i)
+            want[i] = *std::min_element(x.data() + window_start(i, window),
+                                        x.data() + i + 1);
+    });
+    std::vector<double> simd(n);
+    const double vectorized = ns_per_sample(n, [&] {
+        for (std::size_t i = 0; i < n; ++i)
+            simd[i] = *v14::min_element(x.data() + window_start(i, window),
+                                        x.data() + i + 1);
+    });
+    const double sliding = ns_per_sample(n, [&] {
+        ::sliding_min<double> w(window);
+        w.push_range(x.begin(), x.end(), got.begin());
+    });
+    check(got, want, "per sample", window, d);
+    check(simd, want, "00014 min_element", window, d);
+    std::printf("per sample  %-10s W=%-5zu %8.2f ns  (std::min_element %8.2f, "
+                "00014 min_element %8.2f)\n",
+                dist_name(d), window, sliding, recompute, vectorized);
+}
+
+void per_batch(const std::vector<double>& x, std::size_t window,
+               std::size_t batch, dist d)
+{
+    const std::size_t n = x.size();
+    const std::size_t batches = n / batch;
+    std::vector<double> want(batches), pushed(batches), got(batches);
+
+    const double recompute = ns_per_sample(n, [&] {
+        for (std::size_t b = 0; b < batches; ++b) {
+            const std::size_t i = (b + 1) * batch - 1;
+            want[b] = *std::min_element(x.data() + window_start(i, window),
+                                        x.data() + i + 1);
+        }
+    });
+    const double one_by_one = ns_per_sample(n, [&] {
+        ::sliding_min<double> w(window);
+        for (std::size_t b = 0; b < batches; ++b) {
+            for (std::size_t i = b * batch; i < (b + 1) * batch; ++i)
+                w.push(x[i]);
+            pushed[b] = w.min();
+        }
+    });
+    const double batched = ns_per_sample(n, [&] {
+        ::sliding_min<double> w(window);
+        for (std::size_t b = 0; b < batches; ++b) {
+            w.push_range(x.begin() + b * batch, x.begin() + (b + 1) * batch);
+            got[b] = w.min();
+        }
+    });
+    check(pushed, want, "push", window, d);
+    check(got, want, "push_range", window, d);
+    std::printf("per batch   %-10s W=%-5zu %8.2f ns  (push %8.2f, "
+                "recompute %8.2f)\n",
+                dist_name(d), window, batched, one_by_one, recompute);
+}
+
+} // namespace
+
+int main()
+{
+    ::sliding_min_tests();
+
+    const std::size_t n = 1 << 16;
+    const std::size_t batch = 1024;
+    for (dist d : { dist::random, dist::ascending, dist::descending }) {
+        const std::vector<double> x = make_stream(n, d);
+        for (std::size_t window : { 16, 256, 4096 }) {
+            per_sample(x, window, d);
+            per_batch(x, window, batch, d);
+        }
+    }
+    std::fprintf(stderr, "%d mismatch(es)\n", mismatches);
+    return mismatches ? 1 : 0;
+}
@@ -0,0 +1,111 @@
+// 00014's min_element over strings against std::min_element.
+//
+//   g++ -std=c++20 -fconcepts-ts -O2 -pthread bench/string_min.cpp
+//   ./a.out
+//
+// 2^20 short keys with a common prefix, the shape of a table of
+// identifiers, as string, wstring, u16string and u32string. Times are
+// ns/key, best of five runs. 00014's answer must be the same element
+// as std::min_element's (the first of equal minima), checked on the
+// random keys and on keys where the minimum is repeated; a mismatch
+// makes the exit status 1. Containers of char other than the std
+// strings must keep their own operator<, under which a char is
+// signed on x86, so min of two vector<char>s and two array<char, 1>s
+// with a byte above 0x7f is checked against it too.
+
+#include "submissions.h"
+
+namespace {
+
+int mismatches = 0;
+
+template <class C>
+std::vector<std::basic_string<C>> make_keys(std::size_t n)
+{
+    std::uint32_t seed = 7;
+    auto rng = [&seed] { return (seed = seed * 1664525u + 1013904223u) >> 8; };
+    std::vector<std::basic_string<C>> keys(n);
+    for (auto& k : keys) {
+        const char* prefix = "user:";
+        k.assign(prefix, prefix + 5);
+        for (std::size_t len = 3 + rng() % 20; len > 0; --len)
+            k.push_back(C('a' + rng() % 4));
+    }
+    return keys;
+}
+
+// Not const: 00014's InputIterator wants operator-> to yield a
+// value_type*, which a const_iterator over strings does not.
+template <class C>
+void check(std::vector<std::basic_string<C>>& keys, const char* name,
+           const char* what)
+{
+    const auto ours = v14::min_element(keys.begin(), keys.end());
+    const auto theirs = std::min_element(keys.begin(), keys.end());
+    if (ours == theirs) return;
+    std::fprintf(stderr, "MISMATCH %s %s: index %td, std %td\n", name, what,
+                 ours - keys.begin(), theirs - keys.begin());
+    ++mismatches;
+}
+
+template <class C>
+void row(const char* name)
+{
+    auto keys = make_keys<C>(1 << 20);
+    check(keys, name, "random");
+    auto dup = keys;
+    const auto least = *std::min_element(dup.begin(), dup.end());
+    for (std::size_t i = 1; i < dup.size(); i += dup.size() / 7)
+        dup[i] = least;
+    check(dup, name, "repeated minimum");
+
+    auto time = [&](auto run) {
+        double best = 1e300;
+        for (int trial = 0; trial < 5; ++trial) {
+            const auto start = std::chrono::steady_clock::now();
+            run();
+            const std::chrono::duration<double, std::nano> d =
+                std::chrono::steady_clock::now() - start;
+            best = std::min(best, d.count() / keys.size());
+        }
+        return best;
+    };
+    std::size_t at = 0;
+    const double ours = time([&] {
+        at += v14::min_element(keys.begin(), keys.end()) - keys.begin();
+    });
+    const double theirs = time([&] {
+        at += std::min_element(keys.begin(), keys.end()) - keys.begin();
+    });
+    std::printf("%-14s %6.3f ns/key  (std::min_element %6.3f)  %zu\n", name,
+                ours, theirs, at);
+}
+
+template <class S>
+void check_own_order(const S& high, const S& low, const char* name)
+{
+    const bool want_high = high < low;
+    if (&v14::min(high, low) == (want_high ? &high : &low)) return;
+    std::fprintf(stderr, "MISMATCH %s: min doesn't follow operator<\n", name);
+    ++mismatches;
+}
+
+} // namespace
+
+int main()
+{
+    static_assert(v14::CharString<std::string>);
+    static_assert(v14::CharString<std::u32string_view>);
+    static_assert(!v14::CharString<std::vector<char>>);
+    static_assert(!v14::CharString<std::array<char, 1>>);
+    check_own_order(std::vector<char>{ '\x80' }, std::vector<char>{ 'a' },
+                    "vector<char>");
+    check_own_order(std::array<char, 1>{ '\x80' }, std::array<char, 1>{ 'a' },
+                    "array<char, 1>");
+    row<char>("string");
+    row<wchar_t>("wstring");
+    row<char16_t>("u16string");
+    row<char32_t>("u32string");
+    std::fprintf(stderr, "%d mismatch(es)\n", mismatches);
+    return mismatches ? 1 : 0;
+}
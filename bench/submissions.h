@@ -0,0 +1,234 @@
+// The min/for_each submissions that g++ accepts, each included into
+// a namespace of its own, and one adaptor per submission with
+// std::min/std::for_each's shape. Shared by the bench drivers in
+// this directory; include it once, before anything else.
+
+#ifndef BENCH_SUBMISSIONS_H
+#define BENCH_SUBMISSIONS_H
+
+// Every standard header the submissions use, so that their own
+// #includes inside the namespaces below are no-ops.
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <condition_variable>
+#include <coroutine>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <exception>
+#include <forward_list>
+#include <functional>
+#include <initializer_list>
+#include <iostream>
+#include <iterator>
+#include <limits>
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <span>
+#include <string>
+#include <thread>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+// The submissions' own main()s end up in namespaces, where falling
+// off the end isn't an implicit return 0.
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wreturn-type"
+
+// 00010's tests call ::min and ::for_each, so it stays global.
+#include "../concepts/00010.cpp"
+namespace v10 {
+using ::min;
+using ::for_each;
+}
+
+namespace v06 {
+#include "../concepts/00006.cpp"
+}
+namespace v08 {
+#include "../concepts/00008.cpp"
+}
+namespace v09 {
+#include "../concepts/00009.cpp"
+}
+namespace v11 {
+#include "../concepts/00011.cpp"
+}
+namespace v12 {
+#include "../concepts/00012.cpp"
+}
+namespace v14 {
+#include "../concepts/00014.cpp"
+}
+namespace v15 {
+#include "../concepts/00015.cpp"
+}
+namespace v16 {
+#include "../concepts/00016.cpp"
+}
+namespace v17 {
+#include "../concepts/00017.cpp"
+}
+#undef Forward
+namespace v18 {
+#include "../concepts/00018.cpp"
+}
+namespace v19 {
+#include "../concepts/00019.cpp"
+}
+namespace v20 {
+#include "../concepts/00020.cpp"
+}
+
+#pragma GCC diagnostic pop
+
+// 00014 only declares these; its own test code never runs them.
+namespace v14 {
+bool operator<(const MyData& a, const MyData& b)
+{ return a.n < b.n || ( a.n == b.n && a.z < b.z ); }
+static const MyData no_data{};
+MyIter::reference MyIter::operator*() const { return no_data; }
+MyIter::pointer MyIter::operator->() const { return &no_data; }
+MyIter& MyIter::operator++() { return *this; }
+MyIter MyIter::operator++(int) { return *this; }
+bool operator==(const MyIter&, const MyIter&) { return true; }
+bool operator!=(const MyIter&, const MyIter&) { return false; }
+void swap(MyIter&, MyIter&) {}
+}
+
+using v14::MyData;
+
+// One adaptor per submission. A member only exists (by SFINAE on
+// the trailing return type) where the submission accepts the call,
+// so a variant whose constraints reject a type is simply skipped.
+#define BENCH_STD_SHAPE(ns, label)                                     \
+    struct ns##_impl {                                                 \
+        static constexpr const char* name = label;                    \
+        template <class T>                                             \
+        static auto min(const T& a, const T& b)                        \
+            -> decltype(ns::min(a, b)) { return ns::min(a, b); }       \
+        template <class T>                                             \
+        static auto min(std::initializer_list<T> il)                   \
+            -> decltype(ns::min(il)) { return ns::min(il); }           \
+        template <class I, class F>                                    \
+        static auto for_each(I b, I e, F f)                            \
+            -> decltype(ns::for_each(b, e, f), void())                 \
+        { ns::for_each(b, e, f); }                                     \
+    };
+
+struct std_impl {
+    static constexpr const char* name = "std";
+    template <class T>
+    static const T& min(const T& a, const T& b) { return std::min(a, b); }
+    template <class T>
+    static T min(std::initializer_list<T> il) { return std::min(il); }
+    template <class I, class F>
+    static void for_each(I b, I e, F f) { std::for_each(b, e, f); }
+};
+
+BENCH_STD_SHAPE(v06, "00006")
+BENCH_STD_SHAPE(v10, "00010")
+BENCH_STD_SHAPE(v11, "00011")
+BENCH_STD_SHAPE(v14, "00014")
+BENCH_STD_SHAPE(v16, "00016")
+BENCH_STD_SHAPE(v19, "00019")
+#undef BENCH_STD_SHAPE
+
+struct v08_impl {
+    static constexpr const char* name = "00008";
+    template <class T>
+    static auto min(const T& a, const T& b) -> decltype(v08::min(a, b))
+    { return v08::min(a, b); }
+    template <class I>
+    struct range {
+        I b, e;
+        I begin() const { return b; }
+        I end() const { return e; }
+    };
+    template <class I, class F>
+    static auto for_each(I b, I e, F f)
+        -> decltype(v08::for_each(range<I>{b, e}, f), void())
+    { v08::for_each(range<I>{b, e}, f); }
+};
+
+struct v09_impl {
+    static constexpr const char* name = "00009";
+    template <class T>
+    static auto min(const T& a, const T& b) -> decltype(v09::min(a, b))
+    { return v09::min(a, b); }
+};
+
+struct v12_impl {
+    static constexpr const char* name = "00012";
+    template <class T>
+    static auto min(const T& a, const T& b) -> decltype(v12::min(a, b))
+    { return v12::min(a, b); }
+    template <class I, class F>
+    static auto for_each(I b, I e, F f)
+        -> decltype(v12::for_each(b, e, f), void())
+    { v12::for_each(b, e, f); }
+};
+
+struct v15_impl {
+    static constexpr const char* name = "00015";
+    template <class T>
+    static auto min(const T& a, const T& b) -> decltype(v15::min(a, b))
+    { return v15::min(a, b); }
+    template <class I, class F>
+    static auto for_each(I b, I e, F f)
+        -> decltype(v15::for_each(b, e, f), void())
+    { v15::for_each(b, e, f); }
+};
+
+// 00017's min returns whether its first argument is the smaller,
+// not the smaller one, so only its for_each is measured.
+struct v17_impl {
+    static constexpr const char* name = "00017";
+    template <class I, class F>
+    static auto for_each(I b, I e, F f)
+        -> decltype(v17::for_each(b, e, f), void())
+    { v17::for_each(b, e, f); }
+};
+
+// 00018's min only takes its own OrderedOnly type, so only its
+// for_each is measured.
+struct v18_impl {
+    static constexpr const char* name = "00018";
+    template <class I, class F>
+    static auto for_each(I b, I e, F f)
+        -> decltype(v18::foo::for_each(b, e, f), void())
+    { v18::foo::for_each(b, e, f); }
+};
+
+// 00020 only takes a std::function, whose argument type can't be
+// deduced from a lambda.
+struct v20_impl {
+    static constexpr const char* name = "00020";
+    template <class T>
+    static auto min(const T& a, const T& b) -> decltype(v20::_min(a, b))
+    { return v20::_min(a, b); }
+    template <class I, class F>
+    static void for_each(I b, I e, F f)
+    {
+        using R = typename std::iterator_traits<I>::reference;
+        v20::_for_each(b, e, std::function<void(R)>(f));
+    }
+};
+
+#endif // BENCH_SUBMISSIONS_H
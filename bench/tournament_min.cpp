@@ -0,0 +1,99 @@
+// 00014's variadic min, as a tournament, against a chain of binary mins.
+//
+//   g++ -std=c++20 -fconcepts-ts -O2 -pthread bench/tournament_min.cpp
+//   ./a.out
+//
+// A running minimum over a stream taken N-1 values at a time, so that
+// every step's result feeds the next step and the latency of one
+// min(acc, ...) is what's measured: a chain of N-1 comparisons against
+// the tournament's log2(N). For tournament_key both are chains, since
+// min(a, b, c, ...) only builds trees of scalars. Times are ns per
+// min, best of five runs. The tree and the chain must end on the same
+// minimum, and a mismatch makes the exit status 1.
+
+#include "submissions.h"
+
+namespace {
+
+struct tournament_key {
+    int major, minor;
+    bool operator<(const tournament_key& o) const
+    { return major < o.major || (major == o.major && minor < o.minor); }
+};
+
+template <class T>
+bool same(const T& a, const T& b) { return !(a < b) && !(b < a); }
+
+int mismatches = 0;
+
+template <class T, std::size_t... Is>
+double tournament_ns(const std::vector<T>& v, bool tree, T& acc,
+                     std::index_sequence<Is...>)
+{
+    constexpr std::size_t step = sizeof...(Is);
+    const std::size_t n = v.size() / step * step;
+    double best = 1e300;
+    for (int trial = 0; trial < 5; ++trial) {
+        acc = v[0];
+        const auto start = std::chrono::steady_clock::now();
+        for (int rep = 0; rep < 8; ++rep) {
+            if (tree) {
+                for (std::size_t i = 0; i < n; i += step)
+                    acc = v14::min(acc, v[i + Is]...);
+            } else {
+                for (std::size_t i = 0; i < n; i += step) {
+                    const T* m = &acc;
+                    ((m = &v14::min(*m, v[i + Is])), ...);
+                    acc = *m;
+                }
+            }
+        }
+        const std::chrono::duration<double, std::nano> d =
+            std::chrono::steady_clock::now() - start;
+        best = std::min(best, d.count() / (8.0 * n / step));
+    }
+    return best;
+}
+
+template <class T, std::size_t N>
+void row(const char* name, const std::vector<T>& v)
+{
+    auto args = std::make_index_sequence<N - 1>{};
+    T tree_min{}, chain_min{};
+    const double tree = tournament_ns(v, true, tree_min, args);
+    const double chain = tournament_ns(v, false, chain_min, args);
+    const auto last = v.begin() + v.size() / (N - 1) * (N - 1);
+    if (!same(tree_min, chain_min) ||
+        !same(tree_min, *std::min_element(v.begin(), last))) {
+        std::fprintf(stderr, "MISMATCH %s N=%zu\n", name, N);
+        ++mismatches;
+    }
+    std::printf("%-8s N=%-3zu %7.3f ns/min  (chain %7.3f)\n", name, N, tree,
+                chain);
+}
+
+} // namespace
+
+int main()
+{
+    std::uint32_t seed = 11;
+    auto rng = [&seed] { return (seed = seed * 1664525u + 1013904223u) >> 8; };
+    std::vector<double> d(1 << 16);
+    std::vector<int> i(d.size());
+    std::vector<tournament_key> k(d.size());
+    for (std::size_t j = 0; j < d.size(); ++j) {
+        i[j] = int(rng());
+        d[j] = i[j] * 0.5;
+        k[j] = { int(rng() % 16), int(rng()) };
+    }
+    row<double, 3>("double", d);
+    row<double, 4>("double", d);
+    row<double, 8>("double", d);
+    row<double, 16>("double", d);
+    row<int, 4>("int", i);
+    row<int, 16>("int", i);
+    row<tournament_key, 4>("key", k);
+    row<tournament_key, 16>("key", k);
+    std::fprintf(stderr, "%d mismatch(es)\n", mismatches);
+    return mismatches ? 1 : 0;
+}
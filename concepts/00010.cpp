@@ -2,6 +2,12 @@
 #include <vector>
 #include <type_traits>
 #include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <limits>
+#include <utility>
 
 // Reimplement std::min
 
@@ -119,6 +125,258 @@ void min_tests() {
 //
 //
 
+// Reimplement std::minmax and std::minmax_element, plus argmin / argmax
+
+// 1.
+// template< class T >
+// constexpr std::pair<const T&, const T&> minmax( const T& a, const T& b );
+
+// 2.
+// template< class T, class Compare >
+// constexpr std::pair<const T&, const T&> minmax( const T& a, const T& b, Compare comp );
+
+// 3.
+// template< class T >
+// constexpr std::pair<T, T> minmax( std::initializer_list<T> ilist );
+
+// 4.
+// template< class T, class Compare >
+// constexpr std::pair<T, T> minmax( std::initializer_list<T> ilist, Compare comp );
+
+// 5.
+// template< class ForwardIt >
+// constexpr std::pair<ForwardIt, ForwardIt> minmax_element( ForwardIt first, ForwardIt last );
+
+// 6.
+// template< class ForwardIt, class Compare >
+// constexpr std::pair<ForwardIt, ForwardIt> minmax_element( ForwardIt first, ForwardIt last, Compare comp );
+
+// Like std, the first smallest and the last largest element win.
+
+template <typename T>
+concept bool Arithmetic = std::is_arithmetic_v<T>;
+
+namespace minmax_detail {
+
+// The classic pairwise scheme: order each pair with one comparison,
+// then check the smaller against the min and the larger against the
+// max, i.e. 3 comparisons per 2 elements instead of 4.
+template <typename It, typename F>
+constexpr std::pair<It, It> pairwise(It first, It last, F less) {
+    auto lo = first, hi = first;
+    if (first == last || ++first == last) {
+        return { lo, hi };
+    }
+    for (; first != last; ++first) {
+        auto i = first;
+        if (++first == last) {
+            if (less(*i, *lo)) {
+                lo = i;
+            } else if (!less(*i, *hi)) {
+                hi = i;
+            }
+            break;
+        }
+        if (less(*first, *i)) {
+            if (less(*first, *lo)) lo = first;
+            if (!less(*i, *hi)) hi = i;
+        } else {
+            if (less(*i, *lo)) lo = i;
+            if (!less(*first, *hi)) hi = first;
+        }
+    }
+    return { lo, hi };
+}
+
+// Arithmetic values in contiguous memory: keep a whole block of
+// independent running minimums and maximums so that g++ can turn the
+// inner loop into packed min/max instructions (a < b ? a : b is
+// exactly what minps computes), then find the positions with a short
+// search.
+//
+// A NaN compares false both ways, so it is never taken and its lane
+// keeps what it had, unless it is the lane's first value: that lane
+// would stay NaN and hide everything after it, so a NaN in the first
+// block sends the range to the pairwise loop. With a NaN anywhere <
+// is not a strict weak order, and, as for std::minmax_element, which
+// elements come back is unspecified; they are elements of the range.
+template <typename T>
+constexpr std::pair<const T *, const T *> lanes(const T * first, const T * last) {
+    constexpr std::ptrdiff_t width = 64 / sizeof(T);
+    auto less = [](const T & a, const T & b) { return a < b; };
+    if (last - first < 2 * width) {
+        return pairwise(first, last, less);
+    }
+    T lo[width] = {}, hi[width] = {};
+    for (std::ptrdiff_t k = 0; k < width; ++k) {
+        if (!(first[k] == first[k])) {
+            return pairwise(first, last, less);
+        }
+        lo[k] = hi[k] = first[k];
+    }
+    auto block = first + width;
+    for (; last - block >= width; block += width) {
+        for (std::ptrdiff_t k = 0; k < width; ++k) {
+            lo[k] = block[k] < lo[k] ? block[k] : lo[k];
+            hi[k] = hi[k] < block[k] ? block[k] : hi[k];
+        }
+    }
+    T min = lo[0], max = hi[0];
+    for (std::ptrdiff_t k = 1; k < width; ++k) {
+        min = lo[k] < min ? lo[k] : min;
+        max = max < hi[k] ? hi[k] : max;
+    }
+    for (; block != last; ++block) {
+        min = *block < min ? *block : min;
+        max = max < *block ? *block : max;
+    }
+    // min and max are values of the range, so both searches stop.
+    auto min_at = first;
+    while (!(*min_at == min)) ++min_at;
+    auto max_at = last - 1;
+    while (!(*max_at == max)) --max_at;
+    return { min_at, max_at };
+}
+
+} // namespace minmax_detail
+
+// 1.
+LessThanComparable { T }
+constexpr std::pair<const T &, const T &> minmax(const T & a, const T & b) {
+    if (b < a) {
+        return { b, a };
+    }
+    return { a, b };
+}
+
+// 2.
+template <typename T>
+// Same remark as min 2.
+constexpr std::pair<const T &, const T &> minmax(const T & a, const T & b, Compare<T> comp) {
+    if (comp(b, a)) {
+        return { b, a };
+    }
+    return { a, b };
+}
+
+// 5.
+template <typename It>
+requires LessThanComparable<typename std::iterator_traits<It>::value_type>
+constexpr std::pair<It, It> minmax_element(It first, It last) {
+    using T = typename std::iterator_traits<It>::value_type;
+    if constexpr (std::is_pointer_v<It> && Arithmetic<T>) {
+        auto [lo, hi] = minmax_detail::lanes<T>(first, last);
+        return { first + (lo - first), first + (hi - first) };
+    } else {
+        return minmax_detail::pairwise(first, last, [](const auto & a, const auto & b) { return a < b; });
+    }
+}
+
+// 6.
+template <typename It>
+constexpr std::pair<It, It> minmax_element(It first, It last,
+                                           Compare<typename std::iterator_traits<It>::value_type> comp) {
+    return minmax_detail::pairwise(first, last, comp);
+}
+
+// 3.
+template <typename T>
+requires LessThanComparable<T> && CopyConstructible<T>
+constexpr std::pair<T, T> minmax(std::initializer_list<T> ilist) {
+    auto [lo, hi] = ::minmax_element(ilist.begin(), ilist.end());
+    return { *lo, *hi };
+}
+
+// 4.
+template <typename T>
+requires CopyConstructible<T>
+constexpr std::pair<T, T> minmax(std::initializer_list<T> ilist, Compare<T> comp) {
+    auto [lo, hi] = ::minmax_element(ilist.begin(), ilist.end(), comp);
+    return { *lo, *hi };
+}
+
+// Index of the first smallest / first largest element, so the
+// position doesn't need a second pass over an initializer_list.
+template <typename T>
+requires LessThanComparable<T>
+constexpr std::size_t argmin(std::initializer_list<T> ilist) {
+    return std::min_element(ilist.begin(), ilist.end()) - ilist.begin();
+}
+
+template <typename T>
+constexpr std::size_t argmin(std::initializer_list<T> ilist, Compare<T> comp) {
+    return std::min_element(ilist.begin(), ilist.end(), comp) - ilist.begin();
+}
+
+template <typename T>
+requires LessThanComparable<T>
+constexpr std::size_t argmax(std::initializer_list<T> ilist) {
+    return std::max_element(ilist.begin(), ilist.end()) - ilist.begin();
+}
+
+template <typename T>
+constexpr std::size_t argmax(std::initializer_list<T> ilist, Compare<T> comp) {
+    return std::max_element(ilist.begin(), ilist.end(), comp) - ilist.begin();
+}
+
+void minmax_tests() {
+    struct NonComparable { };
+
+    static_assert(::minmax(2, 1).first == 1);
+    static_assert(::minmax(1, 2, greater).first == 2);
+    // ::minmax(NonComparable{}, NonComparable{}); // Error
+
+    static_assert(::minmax({ 3, 1, 4, 1, 5, 9, 2, 6 }) == std::pair { 1, 9 });
+    static_assert(::minmax({ 3, 1, 4, 1, 5, 9, 2, 6 }, greater) == std::pair { 9, 1 });
+    // ::minmax({ Uncopyable { 1 }, Uncopyable { 2 } }); // Error
+
+    static_assert(::argmin({ 3, 1, 4, 1, 5 }) == 1);
+    static_assert(::argmax({ 5, 1, 4, 1, 5 }) == 0);
+    static_assert(::argmin({ 3, 1, 4, 1, 5 }, greater) == 4);
+    // ::argmin({ NonComparable{}, NonComparable{} }); // Error
+
+    // Long enough for the lanes, with ties at both ends: the first
+    // min and the last max win on every path.
+    using at = std::pair<std::ptrdiff_t, std::ptrdiff_t>;
+    constexpr auto ties = [](int path) {
+        int v[1000] = {};
+        for (auto & x : v) x = 7;
+        v[10] = v[500] = 0;
+        v[20] = v[990] = 9;
+        if (path == 0) { // lanes
+            auto [lo, hi] = ::minmax_element(v, v + 1000);
+            return at { lo - v, hi - v };
+        }
+        if (path == 1) { // pairwise, over v reversed
+            auto r = std::reverse_iterator(v + 1000);
+            auto [lo, hi] = ::minmax_element(r, std::reverse_iterator(v));
+            return at { lo - r, hi - r };
+        }
+        auto [lo, hi] = ::minmax_element(v, v + 1000, greater);
+        return at { lo - v, hi - v };
+    };
+    static_assert(ties(0) == at { 10, 990 });
+    static_assert(ties(1) == at { 999 - 500, 999 - 20 });
+    static_assert(ties(2) == at { 20, 500 });
+
+    // A NaN that seeds a lane must not hide that lane's later values.
+    constexpr auto nan_seed = [] {
+        double v[256] = {};
+        for (auto & x : v) x = 1.0;
+        v[1] = std::numeric_limits<double>::quiet_NaN();
+        v[8 * 20 + 1] = 0.5;
+        v[8 * 21 + 1] = 2.0;
+        auto [lo, hi] = ::minmax_element(v, v + 256);
+        return at { lo - v, hi - v };
+    };
+    static_assert(nan_seed() == at { 161, 169 });
+    // ::minmax_element(0, 1); // Error
+}
+
+//
+//
+//
+
 // Reimplement std::for_each
 
 // 1.
@@ -169,3 +427,198 @@ void for_each_tests() {
     // ::for_each(mutable_nums.begin(), mutable_nums.end(), [](auto, auto){}); // Error
 }
 
+//
+//
+//
+
+// Sliding-window min: the least of the last `window` values pushed,
+// kept current in O(1) amortized per push, for a stream that wants
+// "min over the last W samples" after every sample.
+//
+// The candidates form a monotonic deque. A value with a smaller or
+// equal one after it can never be the min again, so each push drops
+// those from the back, and the front, the oldest survivor, is the min
+// until it leaves the window. The deque is a ring buffer allocated
+// once by the constructor, so pushes never allocate; its capacity is
+// the window rounded up to a power of two, so wrapping is a mask.
+
+namespace sliding_min_detail {
+
+struct less {
+    template <typename T>
+    requires LessThanComparable<T>
+    constexpr bool operator()(const T & a, const T & b) const {
+        return a < b;
+    }
+};
+
+constexpr std::size_t ceil_pow2(std::size_t n) {
+    std::size_t p = 1;
+    while (p < n) p <<= 1;
+    return p;
+}
+
+} // namespace sliding_min_detail
+
+template <typename T, typename C = sliding_min_detail::less>
+requires CopyConstructible<T> && std::is_default_constructible_v<T> && Compare<C, T>
+class sliding_min {
+public:
+    explicit sliding_min(std::size_t window, C comp = C { })
+        : window_ { window ? window : 1 },
+          mask_ { sliding_min_detail::ceil_pow2(window_) - 1 },
+          ring_(mask_ + 1),
+          comp_ { comp } { }
+
+    // The least of the last window() values; at least one must have
+    // been pushed.
+    const T & min() const { return slot(0).value; }
+
+    bool empty() const { return size_ == 0; }
+    std::size_t window() const { return window_; }
+    // Values pushed so far, including those that have left the window.
+    std::uint64_t count() const { return count_; }
+
+    void clear() {
+        size_ = 0;
+        count_ = 0;
+    }
+
+    void push(const T & value) {
+        const auto at = count_++;
+        if (size_ != 0 && slot(0).at + window_ <= at) {
+            pop_front();
+        }
+        while (size_ != 0 && !comp_(slot(size_ - 1).value, value)) {
+            --size_;
+        }
+        slot(size_++) = { value, at };
+    }
+
+    // 1.
+    // Pushes [first, last), writing the min after each push to out,
+    // as push() and then min() would.
+    template <typename It, typename Out>
+    requires InputIterator<It>
+    Out push_range(It first, It last, Out out) {
+        for (; first != last; ++first) {
+            push(*first);
+            *out++ = min();
+        }
+        return out;
+    }
+
+    // 2.
+    // Pushes [first, last) when only the min after the whole batch is
+    // wanted. Bidirectional batches aren't pushed one by one: only
+    // their last window() values can matter, and of those only the
+    // ones smaller than everything after them, which a backward scan
+    // against a running min finds. The deque keeps what is smaller
+    // than the batch's min and still in the window, and the batch's
+    // candidates are appended behind it in one go.
+    template <typename It>
+    requires InputIterator<It>
+    void push_range(It first, It last) {
+        using category = typename std::iterator_traits<It>::iterator_category;
+        if constexpr (!std::is_base_of_v<std::bidirectional_iterator_tag, category>) {
+            for (; first != last; ++first) {
+                push(*first);
+            }
+        } else {
+            auto n = static_cast<std::uint64_t>(std::distance(first, last));
+            if (n == 0) {
+                return;
+            }
+            const auto end_at = count_ + n;
+            if (n >= window_) {
+                std::advance(first, n - window_);
+                n = window_;
+                size_ = 0;
+            }
+            // Pass 1: how many candidates, and the batch's min.
+            auto it = std::prev(last);
+            auto best = it;
+            std::size_t candidates = 1;
+            while (it != first) {
+                --it;
+                if (comp_(*it, *best)) {
+                    best = it;
+                    ++candidates;
+                }
+            }
+            while (size_ != 0 && !comp_(slot(size_ - 1).value, *best)) {
+                --size_;
+            }
+            while (size_ != 0 && slot(0).at + window_ < end_at) {
+                pop_front();
+            }
+            // Pass 2: the candidates, written back to front.
+            auto pos = size_ + candidates;
+            auto at = end_at - 1;
+            it = std::prev(last);
+            best = it;
+            slot(--pos) = { *it, at };
+            while (it != first) {
+                --it;
+                --at;
+                if (comp_(*it, *best)) {
+                    best = it;
+                    slot(--pos) = { *it, at };
+                }
+            }
+            size_ += candidates;
+            count_ = end_at;
+        }
+    }
+
+private:
+    struct entry {
+        T value;
+        std::uint64_t at; // position in the stream
+    };
+
+    entry & slot(std::size_t i) { return ring_[(head_ + i) & mask_]; }
+    const entry & slot(std::size_t i) const { return ring_[(head_ + i) & mask_]; }
+
+    void pop_front() {
+        head_ = (head_ + 1) & mask_;
+        --size_;
+    }
+
+    std::size_t window_;
+    std::size_t mask_;
+    std::vector<entry> ring_;
+    C comp_;
+    std::size_t head_ = 0;
+    std::size_t size_ = 0;
+    std::uint64_t count_ = 0;
+};
+
+void sliding_min_tests() {
+    struct NonComparable { };
+
+    auto w = sliding_min<int> { 3 };
+    for (int x : { 5, 3, 4, 6, 7, 1 }) {
+        w.push(x);
+    }
+    // The window was 3, 4, 6, then 4, 6, 7, then 6, 7, 1
+    assert(w.min() == 1 && w.count() == 6);
+
+    auto mins = std::vector<int>(6);
+    auto samples = std::vector { 5, 3, 4, 6, 7, 1 };
+    sliding_min<int> { 3 }.push_range(samples.begin(), samples.end(), mins.begin());
+    assert((mins == std::vector { 5, 3, 3, 3, 4, 1 }));
+
+    auto batched = sliding_min<int> { 3 };
+    batched.push_range(samples.begin(), samples.begin() + 4);
+    assert(batched.min() == 3);
+    batched.push_range(samples.begin() + 4, samples.end());
+    assert(batched.min() == w.min() && batched.count() == w.count());
+
+    auto max_of_last = sliding_min<int, decltype(greater)> { 2, greater };
+    max_of_last.push_range(samples.begin(), samples.end());
+    assert(max_of_last.min() == 7);
+
+    // sliding_min<NonComparable> { 2 }; // Error
+    // sliding_min<int, NonComparable> { 2 }; // Error
+}
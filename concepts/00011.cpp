@@ -1,7 +1,15 @@
 #include <type_traits>
 #include <initializer_list>
 #include <iterator>
-//#include <execution> not available yet
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+//#include <execution> not available yet, so the policies live below
 
 // Using concepts syntax of your choice:
 
@@ -12,7 +20,7 @@ concept bool LessThanComparable = requires (T x) {
 };
 template <typename T>
 concept bool CopyConstructible =
-    std::is_copy_constructible<T>();
+    std::is_copy_constructible<T>::value;
 template <typename C, typename T>
 concept bool Compare = requires (C x, T y) {
     { x(y, y) } -> bool;
@@ -57,11 +65,11 @@ constexpr T min(std::initializer_list<T> il, C comp) {
 // Reimplement std::for_each
 template <typename T>
 concept bool MoveConstructible =
-    std::is_move_constructible<T>() ||
+    std::is_move_constructible<T>::value ||
     CopyConstructible<T>;
 template <typename T>
 concept bool DefaultConstructible =
-    std::is_default_constructible<T>();
+    std::is_default_constructible<T>::value;
 template <typename T>
 concept bool EqualityComparable = requires (T x) {
     { x == x } -> bool;
@@ -86,24 +94,173 @@ concept bool OutputIterator = requires (T x) {
     { x++ } -> const T&;
 };
 template <typename T, typename U>
-concept bool Same = std::is_same<T,U>();
+concept bool Same = std::is_same<T,U>::value;
 template <typename T>
 concept bool ForwardIterator = 
     InputIterator<T> && 
     DefaultConstructible<T> &&
-    ((Same<typename std::iterator_traits<T>::reference, T&> && 
+    ((Same<typename std::iterator_traits<T>::reference,
+           typename std::iterator_traits<T>::value_type&> && 
       OutputIterator<T>) ||
-     Same<typename std::iterator_traits<T>::reference, const T&>
+     Same<typename std::iterator_traits<T>::reference,
+          const typename std::iterator_traits<T>::value_type&>
     ) && requires (T x) {
     { x++ } -> T;
 };
-// Parallelism isn't part of libstdc++ yet
-template <typename> struct is_execution_policy {
-    bool operator()() { return true; }
+template <typename T>
+concept bool RandomAccessIterator =
+    ForwardIterator<T> &&
+    requires (T x, typename std::iterator_traits<T>::difference_type n) {
+    { x += n } -> T&;
+    { x + n } -> T;
+    { x - x } -> typename std::iterator_traits<T>::difference_type;
+    { x[n] } -> typename std::iterator_traits<T>::reference;
 };
+
+// Parallelism isn't part of libstdc++ yet, so here is just enough of it:
+// a persistent pool where every participant owns a deque, pops its own
+// work from the back and steals from the front of everybody else's.
+// A pool of size n runs n-1 background threads; whoever waits on a
+// batch of tasks is the n-th participant and helps instead of blocking.
+class work_stealing_pool {
+public:
+    explicit work_stealing_pool(
+        unsigned size = std::thread::hardware_concurrency())
+        : queues_(size ? size : 1) {
+        for (auto& q : queues_) q = std::make_unique<task_queue>();
+        for (unsigned i = 1; i < queues_.size(); i++)
+            threads_.emplace_back([this, i] { work(i); });
+    }
+    ~work_stealing_pool() {
+        {
+            std::lock_guard<std::mutex> lock(sleep_mutex_);
+            done_ = true;
+        }
+        wake_.notify_all();
+        for (auto& t : threads_) t.join();
+    }
+    work_stealing_pool(const work_stealing_pool&) = delete;
+    work_stealing_pool& operator=(const work_stealing_pool&) = delete;
+
+    unsigned size() const { return queues_.size(); }
+
+    static work_stealing_pool& instance() {
+        static work_stealing_pool pool;
+        return pool;
+    }
+
+    // Counted before it is queued: a run_one that takes it at once
+    // would otherwise decrement pending_ past zero.
+    void submit(std::function<void()> task) {
+        auto& q = *queues_[next_++ % queues_.size()];
+        {
+            std::lock_guard<std::mutex> lock(sleep_mutex_);
+            pending_++;
+        }
+        {
+            std::lock_guard<std::mutex> lock(q.mutex);
+            q.tasks.push_back(std::move(task));
+        }
+        wake_.notify_one();
+    }
+
+    // Runs queued tasks until pred() holds; used by whoever waits
+    // on a batch so it never idles while there is work to steal.
+    template <typename Pred>
+    void help_until(Pred pred) {
+        while (!pred()) {
+            if (!run_one(self_index()))
+                std::this_thread::yield();
+        }
+    }
+
+private:
+    struct task_queue {
+        std::mutex mutex;
+        std::deque<std::function<void()>> tasks;
+    };
+
+    unsigned self_index() const {
+        for (unsigned i = 0; i < threads_.size(); i++)
+            if (threads_[i].get_id() == std::this_thread::get_id())
+                return i + 1;
+        return 0;
+    }
+
+    bool run_one(unsigned self) {
+        std::function<void()> task;
+        for (unsigned k = 0; k < queues_.size() && !task; k++) {
+            auto& q = *queues_[(self + k) % queues_.size()];
+            std::lock_guard<std::mutex> lock(q.mutex);
+            if (q.tasks.empty()) continue;
+            if (k == 0) {
+                task = std::move(q.tasks.back());
+                q.tasks.pop_back();
+            } else {
+                task = std::move(q.tasks.front());
+                q.tasks.pop_front();
+            }
+        }
+        if (!task) return false;
+        {
+            std::lock_guard<std::mutex> lock(sleep_mutex_);
+            pending_--;
+        }
+        task();
+        return true;
+    }
+
+    void work(unsigned self) {
+        for (;;) {
+            if (run_one(self)) continue;
+            std::unique_lock<std::mutex> lock(sleep_mutex_);
+            wake_.wait(lock, [this] { return done_ || pending_ > 0; });
+            if (done_) return;
+        }
+    }
+
+    std::vector<std::unique_ptr<task_queue>> queues_;
+    std::vector<std::thread> threads_;
+    std::atomic<unsigned> next_{0};
+    std::mutex sleep_mutex_;
+    std::condition_variable wake_;
+    std::size_t pending_ = 0;
+    bool done_ = false;
+};
+
+struct sequenced_policy {};
+struct parallel_policy {
+    work_stealing_pool* pool = nullptr; // nullptr: the shared instance()
+    constexpr parallel_policy on(work_stealing_pool& p) const {
+        return parallel_policy{&p};
+    }
+};
+struct parallel_unsequenced_policy {
+    work_stealing_pool* pool = nullptr;
+    constexpr parallel_unsequenced_policy
+    on(work_stealing_pool& p) const {
+        return parallel_unsequenced_policy{&p};
+    }
+};
+inline constexpr sequenced_policy seq{};
+inline constexpr parallel_policy par{};
+inline constexpr parallel_unsequenced_policy par_unseq{};
+
+template <typename T> struct is_execution_policy : std::false_type {};
+template <> struct is_execution_policy<sequenced_policy>
+    : std::true_type {};
+template <> struct is_execution_policy<parallel_policy>
+    : std::true_type {};
+template <> struct is_execution_policy<parallel_unsequenced_policy>
+    : std::true_type {};
+
 template <typename T>
 concept bool ExecutionPolicy = 
-    is_execution_policy<std::decay_t<T>>();
+    is_execution_policy<std::decay_t<T>>::value;
+template <typename T>
+concept bool ParallelPolicy =
+    ExecutionPolicy<T> &&
+    !Same<std::decay_t<T>, sequenced_policy>;
 
 // 1
 template <MoveConstructible UnaryFunction>
@@ -116,11 +273,183 @@ UnaryFunction for_each(InputIterator first, InputIterator last,
 }
 // 2
 template <CopyConstructible UnaryFunction>
-void for_each(ExecutionPolicy&& policy, ForwardIterator first,
+void for_each(ExecutionPolicy&&, ForwardIterator first,
               ForwardIterator last, UnaryFunction f) {
-    // Who needs parallelism anyway
+    // Serial: seq, and parallel policies over ranges we can't split
     for (; first != last; first++) {
         f(*first);
     }
 }
+// 3
+template <CopyConstructible UnaryFunction>
+void for_each(ParallelPolicy&& policy, RandomAccessIterator first,
+              RandomAccessIterator last, UnaryFunction f) {
+    auto& pool = policy.pool ? *policy.pool
+                             : work_stealing_pool::instance();
+    auto n = last - first;
+    // A few chunks per participant so stealing can even out the load,
+    // but never so small that queueing dominates the element work.
+    const decltype(n) min_chunk = 2048;
+    const auto chunks = std::min<decltype(n)>(
+        pool.size() * 4, (n + min_chunk - 1) / min_chunk);
+    if (chunks <= 1) {
+        for (; first != last; ++first) f(*first);
+        return;
+    }
+    std::atomic<decltype(n)> remaining(chunks);
+    for (decltype(n) c = 0; c < chunks; c++) {
+        auto b = first + n * c / chunks;
+        auto e = first + n * (c + 1) / chunks;
+        // Like std::execution, an exception escaping f terminates.
+        pool.submit([b, e, &f, &remaining]() noexcept {
+            UnaryFunction g(f);
+            for (auto it = b; it != e; ++it) g(*it);
+            remaining--;
+        });
+    }
+    pool.help_until([&remaining] { return remaining == 0; });
+}
+
+// Early exit: f returns whether to go on, as a PredicateResult (as in
+// 00018: anything that can be an if condition), and the result is the
+// position of the first element it rejected, or last.
+template <typename T>
+concept bool PredicateResult = requires (T t) {
+    t ? 1 : 1;
+    { (bool) t };
+};
+template <typename F, typename T>
+concept bool UnaryPredicate = requires (F f, T x) {
+    { f(x) } -> PredicateResult;
+};
+template <typename It>
+using reference_t = typename std::iterator_traits<It>::reference;
+
+// 1
+template <MoveConstructible F, typename It>
+requires InputIterator<It> && UnaryPredicate<F, reference_t<It>>
+It for_each_while(It first, It last, F f) {
+    for (; first != last; ++first) {
+        if (!bool(f(*first))) break;
+    }
+    return first;
+}
+// 2
+template <typename Policy, typename It, CopyConstructible F>
+requires ExecutionPolicy<Policy> && ForwardIterator<It> &&
+         UnaryPredicate<F, reference_t<It>>
+It for_each_while(Policy&&, It first, It last, F f) {
+    return for_each_while(first, last, f);
+}
+// 3
+// The earliest rejected position found so far doubles as the
+// cancellation flag. Nothing past it needs visiting, so each chunk
+// checks it before every element and chunks queued behind it return
+// at once; chunks before it still run, since a rejection there would
+// come first. Chunks are queued last to first, because each
+// participant pops its own newest task: that way the earliest chunks
+// run first, and a rejection in them cancels the rest before they
+// start. Every element before the result was accepted; as with
+// for_each(par), elements after it may or may not have been visited.
+template <typename Policy, typename It, CopyConstructible F>
+requires ParallelPolicy<Policy> && RandomAccessIterator<It> &&
+         UnaryPredicate<F, reference_t<It>>
+It for_each_while(Policy&& policy, It first, It last, F f) {
+    auto& pool = policy.pool ? *policy.pool
+                             : work_stealing_pool::instance();
+    auto n = last - first;
+    const decltype(n) min_chunk = 2048;
+    const auto chunks = std::min<decltype(n)>(
+        pool.size() * 4, (n + min_chunk - 1) / min_chunk);
+    if (chunks <= 1) return for_each_while(first, last, f);
+    std::atomic<decltype(n)> stop(n);
+    std::atomic<decltype(n)> remaining(chunks);
+    for (decltype(n) c = chunks; c-- > 0;) {
+        const decltype(n) b = n * c / chunks;
+        const decltype(n) e = n * (c + 1) / chunks;
+        pool.submit([first, b, e, &f, &stop, &remaining]() noexcept {
+            F g(f);
+            for (auto i = b;
+                 i < e && i < stop.load(std::memory_order_relaxed); ++i) {
+                if (!bool(g(first[i]))) {
+                    auto seen = stop.load(std::memory_order_relaxed);
+                    while (i < seen && !stop.compare_exchange_weak(
+                               seen, i, std::memory_order_relaxed)) {}
+                    break;
+                }
+            }
+            remaining--;
+        });
+    }
+    pool.help_until([&remaining] { return remaining == 0; });
+    return first + stop.load(std::memory_order_relaxed);
+}
+
+// The converse: stops at the first element f accepts. The return
+// type is deduced from f's, so for_each_until's constraints reject an
+// f whose result can't be tested.
+template <typename F>
+struct negated_predicate {
+    F f;
+    template <typename T>
+    auto operator()(T&& x) -> decltype(!bool(f(std::forward<T>(x)))) {
+        return !bool(f(std::forward<T>(x)));
+    }
+};
+
+template <typename It, typename F>
+requires requires (It i, negated_predicate<F> g) { for_each_while(i, i, g); }
+It for_each_until(It first, It last, F f) {
+    return for_each_while(first, last, negated_predicate<F>{std::move(f)});
+}
+template <typename Policy, typename It, typename F>
+requires requires (Policy&& p, It i, negated_predicate<F> g) {
+    for_each_while(std::forward<Policy>(p), i, i, g);
+}
+It for_each_until(Policy&& policy, It first, It last, F f) {
+    return for_each_while(std::forward<Policy>(policy), first, last,
+                          negated_predicate<F>{std::move(f)});
+}
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
 
+// Speedup of for_each(par) over pools of 1..N participants, then a
+// validation pass that meets a bad record 1% of the way in.
+int main() {
+    std::vector<double> v(1 << 24, 2.0);
+    auto work = [](double& x) { x = std::sqrt(x) + 1.0; };
+    auto time = [&](auto policy) {
+        auto start = std::chrono::steady_clock::now();
+        for_each(policy, v.begin(), v.end(), work);
+        std::chrono::duration<double, std::milli> d =
+            std::chrono::steady_clock::now() - start;
+        return d.count();
+    };
+    const double serial = time(seq);
+    std::printf("seq        %8.2f ms\n", serial);
+    const unsigned n = std::max(1u, std::thread::hardware_concurrency());
+    for (unsigned cores = 1; cores <= n; cores++) {
+        work_stealing_pool pool(cores);
+        const double ms = time(par.on(pool));
+        std::printf("par x%-3u   %8.2f ms  speedup %5.2f\n",
+                    cores, ms, serial / ms);
+    }
+
+    v[v.size() / 100] = -1.0;
+    auto valid = [](const double& x) { return std::sqrt(x) == std::sqrt(x); };
+    auto time_while = [&](auto policy) {
+        auto start = std::chrono::steady_clock::now();
+        auto bad = for_each_while(policy, v.begin(), v.end(), valid);
+        std::chrono::duration<double, std::milli> d =
+            std::chrono::steady_clock::now() - start;
+        std::printf("%8.2f ms  (stopped at %td)", d.count(), bad - v.begin());
+    };
+    const double full = time(par);
+    std::printf("while seq  ");
+    time_while(seq);
+    std::printf("\nwhile par  ");
+    time_while(par);
+    std::printf("\nfull scan  %8.2f ms\n", full);
+}
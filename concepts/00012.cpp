@@ -3,6 +3,8 @@
 #include <type_traits>
 #include <initializer_list>
 #include <functional>
+#include <iterator>
+#include <utility>
 
 template<typename T>
 concept bool Ordered =
@@ -50,6 +52,62 @@ concept bool Iterator
 template<Iterator T>
 using value_type_t = std::decay_t<decltype(*std::declval<T>())>;
 
+template<typename R>
+concept bool Range =
+	requires(R& r)
+	{
+		std::begin(r);
+		std::end(r);
+		requires Iterator<decltype(std::begin(r))>;
+	};
+
+template<typename R>
+using range_iterator_t = decltype(std::begin(std::declval<R&>()));
+
+// A projection maps an element to the key that comp or f sees, so
+// callers name the key once (&MyData::n, say) instead of writing a
+// comparator that recomputes it on both sides.
+template<typename Proj, typename T>
+concept bool Projection =
+	requires (Proj p, T t)
+	{
+		std::invoke(p, t);
+	};
+
+template<typename Proj, typename T>
+using projected_t = std::decay_t<decltype(
+	std::invoke(std::declval<Proj&>(), *std::declval<T>()))>;
+
+// Wrapping a projection in cache_keys asks min to compute each
+// element's key once and keep the best key so far, rather than
+// projecting both sides of every comparison. That halves the keys
+// computed, at the price of materializing them; without it a
+// projection returning a reference to a member never copies one.
+template<typename Proj>
+struct cached_projection
+{
+	Proj proj;
+
+	template<typename T>
+	constexpr decltype(auto) operator()(T&& t) const
+	{
+		return std::invoke(proj, std::forward<T>(t));
+	}
+};
+
+template<typename Proj>
+constexpr
+cached_projection<Proj> cache_keys(Proj proj)
+{
+	return { proj };
+}
+
+template<typename Proj>
+constexpr bool is_cached_projection = false;
+
+template<typename Proj>
+constexpr bool is_cached_projection<cached_projection<Proj>> = true;
+
 
 // Reimplement std::min
 template<Ordered T>
@@ -98,6 +156,67 @@ const T& min (const T& lhs, const T& rhs, C comp)
 	return comp(lhs,rhs) ? lhs : rhs;
 }
 
+// Returns the first of the elements with the least key; e for an
+// empty range.
+template<Iterator T, typename C, typename P>
+	requires Projection<P, decltype(*std::declval<T>())>
+		&& Comparator<C, projected_t<P, T>>
+constexpr
+T min_element (T b, T e, C comp, P proj)
+{
+	if (b == e)
+	{
+		return e;
+	}
+	T it = b;
+	if constexpr (is_cached_projection<P>)
+	{
+		projected_t<P, T> best = std::invoke(proj.proj, *it);
+		for (++b; b != e; ++b)
+		{
+			projected_t<P, T> key = std::invoke(proj.proj, *b);
+			if (comp(key, best))
+			{
+				best = std::move(key);
+				it = b;
+			}
+		}
+	}
+	else
+	{
+		for (++b; b != e; ++b)
+		{
+			if (comp(std::invoke(proj, *b), std::invoke(proj, *it)))
+			{
+				it = b;
+			}
+		}
+	}
+	return it;
+}
+
+// Like ranges::min, the element is returned by value, since range
+// may be a temporary; it must not be empty.
+template<Range R, typename C, typename P>
+	requires CopyConstructible<value_type_t<range_iterator_t<R>>>
+		&& Projection<P, decltype(*std::declval<range_iterator_t<R>>())>
+		&& Comparator<C, projected_t<P, range_iterator_t<R>>>
+constexpr
+value_type_t<range_iterator_t<R>> min (R&& range, C comp, P proj)
+{
+	return *min_element(std::begin(range), std::end(range), comp, proj);
+}
+
+template<typename T, typename C, typename P>
+	requires CopyConstructible<T>
+		&& Projection<P, const T&>
+		&& Comparator<C, projected_t<P, const T*>>
+constexpr
+T min (std::initializer_list<T> list, C comp, P proj)
+{
+	return *min_element(list.begin(), list.end(), comp, proj);
+}
+
 // Reimplement std::for_each
 template<Iterator T, typename Func>
 	requires Callable<Func, value_type_t<T>>
@@ -112,3 +231,16 @@ template<Iterator T, typename Func>
 		return f;
 	}
 
+template<Iterator T, typename Func, typename P>
+	requires Projection<P, decltype(*std::declval<T>())>
+		&& Callable<Func, projected_t<P, T>>
+		&& CopyConstructible<Func>
+	Func for_each(T b, T e, Func f, P proj)
+	{
+		while(b != e)
+		{
+			f(std::invoke(proj, *b));
+			++b;
+		}
+		return f;
+	}
@@ -1,7 +1,21 @@
 #include <type_traits>
 #include <utility>
+#include <atomic>
 #include <initializer_list>
 #include <iterator>
+#include <cstddef>
+#include <cstring>
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <vector>
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
 
 // Using concepts syntax of your choice:
 
@@ -13,14 +27,11 @@
 // peeking at the Ranges TS, which I believe defines many of
 // these or similar things also...
 
+// A fold, so one instantiation no matter how long List is
+// (resolve_arrow's Examined... grows with every operator->).
 template <typename T, typename... List>
-struct type_in_list : public std::false_type {};
-template <typename T, typename... List>
-struct type_in_list<T, T, List...> : public std::true_type {};
-template <typename T, typename Head, typename... List>
-struct type_in_list<T, Head, List...> :
-    public std::bool_constant<
-    type_in_list<T, List...>::value> {};
+struct type_in_list :
+    public std::bool_constant<(std::is_same_v<T, List> || ...)> {};
 
 template <typename T>
 concept bool Signed = std::is_signed_v<T>;
@@ -118,8 +129,12 @@ template <typename T>
 concept bool Scalar =
     Arithmetic<T> || Enum<T> || AnyPointer<T> || IsNullPtr<T>;
 
+// The order of || doesn't matter for subsumption, but it does
+// for satisfaction: class types are the common case, and testing
+// them first skips the whole Scalar chain. (g++ already caches
+// each atom per type, so every trait is evaluated once anyway.)
 template <typename T>
-concept bool Object = Scalar<T> || Array<T> || ClassLike<T>;
+concept bool Object = ClassLike<T> || Scalar<T> || Array<T>;
 
 template <typename T>
 concept bool Overloadable = ClassLike<T> || Enum<T>;
@@ -135,7 +150,7 @@ concept bool DestructibleClass = ClassLike<T> &&
 
 template <typename T>
 concept bool CanCallDestructor =
-    Scalar<T> || DestructibleClass<T>;
+    DestructibleClass<T> || Scalar<T>;
 
 template <typename T>
 concept bool DestructibleArray =
@@ -288,6 +303,358 @@ constexpr T min(std::initializer_list<T> il, Compare comp)
     return *best;
 }
 
+// Arithmetic types get a lane-wise path. Ties keep std::min's
+// answer, the first of the equal minimal elements (which matters
+// for -0.0 and +0.0). NaNs are treated as missing samples and
+// skipped; only if every element is NaN is the first one returned.
+// One pass finds the minimal value with several independent
+// accumulators, a second finds its first position, so neither pass
+// is a loop-carried compare-and-select chain.
+template <typename T>
+concept bool SimdArithmetic =
+    Arithmetic<T> && !SameType<std::remove_cv_t<T>, bool> &&
+    sizeof(T) <= 8 &&
+    !SameType<std::remove_cv_t<T>, long double>;
+
+namespace simd_min_detail {
+    // Lanes are plain integers of the same width and signedness
+    // (char16_t, wchar_t and friends can't be vector elements).
+    template <typename T, bool IsFloat = Floating<T>>
+    struct lane { using type = T; };
+    template <typename T>
+    struct lane<T, false> {
+        using type = std::conditional_t<std::is_signed_v<T>,
+            std::make_signed_t<T>, std::make_unsigned_t<T>>;
+    };
+    template <typename T, std::size_t Bytes>
+    struct vec {
+        typedef typename lane<T>::type type
+            __attribute__((vector_size(Bytes)));
+    };
+
+    template <typename T>
+    constexpr bool is_nan(const T& x) { return x != x; }
+
+    template <typename T>
+    constexpr const T* scalar(const T* first, const T* last)
+    {
+        const T* best = first;
+        while ( best != last && is_nan(*best) ) ++best;
+        if ( best == last ) return first;
+        for ( const T* p = best + 1; p != last; ++p )
+            if ( *p < *best ) best = p;
+        return best;
+    }
+
+    // Always inlined, so the vector code is generated with the ISA
+    // of the target-specific caller below.
+    template <std::size_t Bytes, typename T>
+    __attribute__((always_inline)) inline
+    const T* vectorized(const T* first, const T* last)
+    {
+        using L = typename lane<T>::type;
+        using V = typename vec<T, Bytes>::type;
+        constexpr std::size_t lanes = Bytes / sizeof(T);
+        constexpr std::size_t step = 4 * lanes;
+        const std::size_t n = last - first;
+        if ( n < step ) return scalar(first, last);
+
+        // min(x, acc) keeps acc when x is NaN, since x<acc is false.
+        const L top = Floating<T> ? std::numeric_limits<L>::infinity()
+                                  : std::numeric_limits<L>::max();
+        V acc0 = V{} + top, acc1 = acc0, acc2 = acc0, acc3 = acc0;
+        std::size_t i = 0;
+        for ( ; i + step <= n; i += step ) {
+            V x0, x1, x2, x3;
+            std::memcpy(&x0, first + i, Bytes);
+            std::memcpy(&x1, first + i + lanes, Bytes);
+            std::memcpy(&x2, first + i + 2*lanes, Bytes);
+            std::memcpy(&x3, first + i + 3*lanes, Bytes);
+            acc0 = x0 < acc0 ? x0 : acc0;
+            acc1 = x1 < acc1 ? x1 : acc1;
+            acc2 = x2 < acc2 ? x2 : acc2;
+            acc3 = x3 < acc3 ? x3 : acc3;
+        }
+        acc0 = acc1 < acc0 ? acc1 : acc0;
+        acc2 = acc3 < acc2 ? acc3 : acc2;
+        acc0 = acc2 < acc0 ? acc2 : acc0;
+        L m = acc0[0];
+        for ( std::size_t l = 1; l < lanes; ++l )
+            if ( acc0[l] < m ) m = acc0[l];
+        for ( ; i < n; ++i ) {
+            L x;
+            std::memcpy(&x, first + i, sizeof x);
+            if ( x < m ) m = x;
+        }
+
+        // First position holding m; == also matches -0.0 to +0.0.
+        const V splat = V{} + m;
+        for ( i = 0; i + lanes <= n; i += lanes ) {
+            V x;
+            std::memcpy(&x, first + i, Bytes);
+            auto eq = x == splat;
+            bool any = false;
+            for ( std::size_t l = 0; l < lanes; ++l ) any |= eq[l] != 0;
+            if ( any ) break;
+        }
+        for ( ; i < n; ++i ) {
+            L x;
+            std::memcpy(&x, first + i, sizeof x);
+            if ( x == m ) return first + i;
+        }
+        return first; // only NaNs
+    }
+
+#if defined(__x86_64__) || defined(__i386__)
+    template <typename T>
+    __attribute__((target("avx512f,avx512bw")))
+    const T* avx512(const T* first, const T* last)
+    { return vectorized<64>(first, last); }
+    template <typename T>
+    __attribute__((target("avx2")))
+    const T* avx2(const T* first, const T* last)
+    { return vectorized<32>(first, last); }
+    template <typename T>
+    __attribute__((target("sse2")))
+    const T* sse2(const T* first, const T* last)
+    { return vectorized<16>(first, last); }
+
+    template <typename T>
+    const T* dispatch(const T* first, const T* last)
+    {
+        if ( __builtin_cpu_supports("avx512bw") )
+            return avx512(first, last);
+        if ( __builtin_cpu_supports("avx2") )
+            return avx2(first, last);
+        if ( __builtin_cpu_supports("sse2") )
+            return sse2(first, last);
+        return scalar(first, last);
+    }
+#else
+    template <typename T>
+    const T* dispatch(const T* first, const T* last)
+    { return vectorized<16>(first, last); }
+#endif
+}
+
+// Returns last only for an empty range.
+template <Arithmetic T>
+constexpr const T* min_element(const T* first, const T* last)
+{
+    if ( first == last ) return last;
+    if ( __builtin_is_constant_evaluated() ) // g++/clang builtin
+        return simd_min_detail::scalar(first, last);
+    if constexpr ( SimdArithmetic<T> )
+        return simd_min_detail::dispatch(first, last);
+    else
+        return simd_min_detail::scalar(first, last);
+}
+
+// Arithmetic already implies CopyConstructible via Scalar; spelling
+// it out makes g++ normalize both of them and the check never ends.
+template <Arithmetic T>
+constexpr T min(std::initializer_list<T> il)
+{
+    return *min_element(il.begin(), il.end());
+}
+
+// min(a, b, c, ...) of scalars as a balanced tournament: the two
+// halves of the arguments are reduced independently and their
+// winners compared, so N arguments take log2(N) dependent
+// comparisons instead of the N-1 of a left-to-right chain, and the
+// rest can issue in parallel. The tree is laid out at compile time
+// over a tuple of references, so no list of the arguments is built,
+// and a reference to the winning argument itself is returned. Each
+// comparison keeps the left side on ties and the leaves keep
+// argument order, so like std::min it returns the first of the
+// equal minimal arguments.
+//
+// Class types are reduced left to right instead. Their < is usually
+// a branch, and a running minimum predicts well (the minimum so far
+// rarely changes) where the leaves of a tree compare arbitrary pairs
+// and mispredict: 16 two-field keys took 75 ns as a tree, 8 as a
+// chain.
+namespace tournament_detail {
+    template <std::size_t First, std::size_t Count, typename Args>
+    constexpr decltype(auto) reduce(const Args& args)
+    {
+        if constexpr ( Count == 1 ) {
+            return std::get<First>(args);
+        } else {
+            constexpr std::size_t half = Count / 2;
+            const auto& l = reduce<First, half>(args);
+            const auto& r = reduce<First + half, Count - half>(args);
+            return r<l ? r : l;
+        }
+    }
+}
+
+// c is spelled out so that for three arguments this is more
+// specialized than std::min(a, b, comp), which ADL brings in for
+// arguments of std types.
+template <LessComparable T, typename... Rest>
+    requires (SameType<T, Rest> && ...)
+constexpr const T& min(const T& a, const T& b, const T& c,
+                       const Rest&... rest)
+{
+    if constexpr ( Scalar<T> ) {
+        return tournament_detail::reduce<0, 3 + sizeof...(Rest)>(
+            std::forward_as_tuple(a, b, c, rest...) );
+    } else {
+        const T* best = std::addressof(b<a ? b : a);
+        if ( c < *best ) best = std::addressof(c);
+        ( ( best = std::addressof(rest < *best ? rest : *best) ), ... );
+        return *best;
+    }
+}
+
+// Strings: std::basic_string and std::basic_string_view of a
+// character type with the standard std::char_traits, whose order is
+// the one char_less below reproduces. Other containers of characters,
+// and strings with their own traits, keep their own operator<.
+template <typename S>
+struct std_string : std::false_type {};
+template <typename C, typename A>
+struct std_string<std::basic_string<C, std::char_traits<C>, A>> :
+    std::true_type {};
+template <typename C>
+struct std_string<std::basic_string_view<C, std::char_traits<C>>> :
+    std::true_type {};
+
+template <typename S>
+concept bool CharString =
+    std_string<std::remove_cv_t<S>>::value &&
+    CharType<typename S::value_type>;
+
+// Two strings are ordered by their first differing character, which
+// is found a block of bytes at a time: compare, movemask, count
+// trailing zeros. Bytes are compared whatever the character width,
+// so the first differing byte lies in the first differing character
+// of wide strings too. The block is 32 bytes when the translation
+// unit is built for AVX2, 16 with SSE2 (every x86-64), and 8 bytes
+// in a general register otherwise. Unlike the arithmetic min above
+// this isn't dispatched at run time: with short keys the check
+// would cost as much as the compare, and g++ won't inline AVX2
+// intrinsics into a function not itself built for AVX2.
+namespace simd_string_detail {
+#if defined(__AVX2__)
+    constexpr std::size_t block = 32;
+    inline unsigned differing(const unsigned char* a, const unsigned char* b)
+    {
+        const __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a));
+        const __m256i y = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b));
+        return ~unsigned(_mm256_movemask_epi8(_mm256_cmpeq_epi8(x, y)));
+    }
+#elif defined(__SSE2__)
+    constexpr std::size_t block = 16;
+    inline unsigned differing(const unsigned char* a, const unsigned char* b)
+    {
+        const __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(a));
+        const __m128i y = _mm_loadu_si128(reinterpret_cast<const __m128i*>(b));
+        return ~unsigned(_mm_movemask_epi8(_mm_cmpeq_epi8(x, y))) & 0xFFFFu;
+    }
+#else
+    constexpr std::size_t block = 0;
+    inline unsigned differing(const unsigned char*, const unsigned char*)
+    { return 0; }
+#endif
+
+    // Index of the first set byte of a nonzero XOR of two words
+    // loaded from memory.
+    template <typename Word>
+    std::size_t first_byte(Word x)
+    {
+#if __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+        return __builtin_ctzll(x) / 8;
+#else
+        return ( __builtin_clzll(x) - 8 * (8 - sizeof(Word)) ) / 8;
+#endif
+    }
+
+    // Compares the Word at a+i and b+i; sets *at to the first
+    // differing byte and returns true if there is one.
+    template <typename Word>
+    bool word_differs(const unsigned char* a, const unsigned char* b,
+                      std::size_t i, std::size_t* at)
+    {
+        Word x, y;
+        std::memcpy(&x, a + i, sizeof x);
+        std::memcpy(&y, b + i, sizeof y);
+        if ( x == y ) return false;
+        *at = i + first_byte<Word>(x ^ y);
+        return true;
+    }
+
+    // The first of n bytes at which a and b differ, or n. The last
+    // partial block or word is read as a whole one ending at n,
+    // overlapping bytes already known to be equal, so nothing past
+    // either string is ever read.
+    inline std::size_t mismatch(const unsigned char* a,
+                                const unsigned char* b, std::size_t n)
+    {
+        std::size_t at;
+        if ( block && n >= block ) {
+            for ( std::size_t i = 0; ; i += block ) {
+                if ( i + block > n ) i = n - block;
+                if ( unsigned m = differing(a + i, b + i) )
+                    return i + __builtin_ctz(m);
+                if ( i + block == n ) return n;
+            }
+        }
+        if ( n >= 8 ) {
+            for ( std::size_t i = 0; ; i += 8 ) {
+                if ( i + 8 > n ) i = n - 8;
+                if ( word_differs<std::uint64_t>(a, b, i, &at) ) return at;
+                if ( i + 8 == n ) return n;
+            }
+        }
+        if ( n >= 4 ) {
+            if ( word_differs<std::uint32_t>(a, b, 0, &at) ||
+                 word_differs<std::uint32_t>(a, b, n - 4, &at) )
+                return at;
+            return n;
+        }
+        std::size_t i = 0;
+        while ( i < n && a[i] == b[i] ) ++i;
+        return i;
+    }
+
+    // char compares as unsigned char, as std::char_traits<char> does;
+    // every other character type by value.
+    template <typename C>
+    constexpr bool char_less(C x, C y)
+    {
+        if constexpr ( SameType<std::remove_cv_t<C>, char> )
+            return static_cast<unsigned char>(x) < static_cast<unsigned char>(y);
+        else
+            return x < y;
+    }
+
+    template <typename C>
+    bool less(const C* x, std::size_t nx, const C* y, std::size_t ny)
+    {
+        const std::size_t n = nx < ny ? nx : ny;
+        const std::size_t k = mismatch(
+            reinterpret_cast<const unsigned char*>(x),
+            reinterpret_cast<const unsigned char*>(y), n * sizeof(C) )
+            / sizeof(C);
+        if ( k == n ) return nx < ny;
+        return char_less(x[k], y[k]);
+    }
+
+    template <CharString S>
+    bool less(const S& a, const S& b)
+    { return less(a.data(), a.size(), b.data(), b.size()); }
+}
+
+template <LessComparable S> requires CharString<S>
+constexpr const S& min(const S& a, const S& b)
+{
+    if ( __builtin_is_constant_evaluated() )
+        return b<a ? b : a;
+    return simd_string_detail::less(b, a) ? b : a;
+}
+
 // Reimplement std::for_each
 
 template <typename T>
@@ -371,7 +738,7 @@ public:
 };
 
 template <typename T>
-concept bool InputIterator =
+concept bool InputIteratorRequirements =
     ( ObjPointer<T> && Swappable<T> ) ||
     ( Iterator<T> &&
       std::is_base_of_v<
@@ -393,6 +760,15 @@ concept bool InputIterator =
              typename std::iterator_traits<T>::value_type*>
     ) );
 
+// Spelled out, the requirements above normalize into so many
+// clauses that g++ never finishes ordering two overloads which both
+// mention them. Checked through a nested requirement they become a
+// single atomic constraint, which the refinements further down can
+// still subsume.
+template <typename T>
+concept bool InputIterator =
+    requires { requires InputIteratorRequirements<T>; };
+
 template <InputIterator Iter,
           Callable<void,
               typename std::iterator_traits<Iter>::reference>
@@ -403,6 +779,595 @@ void for_each( Iter first, Iter last, Func f )
         f( *first );
 }
 
+// The rest of the iterator hierarchy. Each level is the previous
+// one && something, so the overloads below are ordered by
+// subsumption. Pointers satisfy every level directly, since
+// iterator_traits<T*> has nothing to add.
+template <typename T, typename Tag>
+concept bool IteratorCategoryAtLeast =
+    std::is_base_of_v<
+        Tag, typename std::iterator_traits<T>::iterator_category>;
+
+template <typename T>
+concept bool ForwardIterator =
+    InputIterator<T> &&
+    ( ObjPointer<T> ||
+      ( IteratorCategoryAtLeast<T, std::forward_iterator_tag> &&
+        std::is_default_constructible_v<T> &&
+        requires (T iter) {
+            requires SameType<decltype(iter++), T>;
+        } ) );
+
+template <typename T>
+concept bool BidirectionalIterator =
+    ForwardIterator<T> &&
+    ( ObjPointer<T> ||
+      ( IteratorCategoryAtLeast<T, std::bidirectional_iterator_tag> &&
+        requires (T iter) {
+            requires SameType<decltype(--iter), T&>;
+            requires SameType<decltype(iter--), T>;
+        } ) );
+
+template <typename T>
+concept bool RandomAccessIterator =
+    BidirectionalIterator<T> &&
+    ( ObjPointer<T> ||
+      ( IteratorCategoryAtLeast<T, std::random_access_iterator_tag> &&
+        requires (T iter, const T citer,
+                  typename std::iterator_traits<T>::difference_type n) {
+            requires SameType<decltype(iter += n), T&>;
+            requires SameType<decltype(iter -= n), T&>;
+            requires SameType<decltype(citer + n), T>;
+            requires SameType<decltype(n + citer), T>;
+            requires SameType<decltype(citer - n), T>;
+            requires SameType<decltype(citer - citer),
+                typename std::iterator_traits<T>::difference_type>;
+            requires SameType<decltype(citer[n]),
+                typename std::iterator_traits<T>::reference>;
+            { citer < citer } -> bool;
+        } ) );
+
+// Contiguity can't be seen through iterator_traits before C++20,
+// so class-type iterators opt in by specializing this trait (the
+// C++20 library's contiguous_iterator is consulted when present).
+template <typename T>
+struct is_contiguous_iterator : std::bool_constant<
+#if __cpp_lib_concepts
+    std::contiguous_iterator<T>
+#else
+    false
+#endif
+    > {};
+
+template <typename T>
+concept bool ContiguousIterator =
+    RandomAccessIterator<T> &&
+    ( ObjPointer<T> || is_contiguous_iterator<T>::value );
+
+// Counted, so the trip count is known before the loop starts and
+// the iterator's operator!= is never called. Stepping the iterator
+// rather than indexing off first keeps segmented iterators such as
+// deque's from redoing their block arithmetic on every element.
+template <RandomAccessIterator Iter,
+          Callable<void,
+              typename std::iterator_traits<Iter>::reference>
+          Func>
+void for_each( Iter first, Iter last, Func f )
+{
+    for ( auto n = last - first; n > 0; --n, ++first )
+        f( *first );
+}
+
+// A counted loop over a raw pointer, unrolled by four. Unrolling by
+// hand instead hides the reduction in f from the loop vectorizer.
+template <ContiguousIterator Iter,
+          Callable<void,
+              typename std::iterator_traits<Iter>::reference>
+          Func>
+void for_each( Iter first, Iter last, Func f )
+{
+    if ( first == last ) return;
+    const auto p = std::addressof( *first );
+    const std::ptrdiff_t n = last - first;
+#pragma GCC unroll 4
+    for ( std::ptrdiff_t i = 0; i < n; ++i )
+        f( p[i] );
+}
+
+// Node-based iterators (lists, trees) can't be counted or
+// vectorized, and each ++ is a dependent load. Walking a second
+// iterator Distance nodes ahead and prefetching what it reaches
+// overlaps those loads with the work f does, and when the values
+// are pointers the objects they point to are prefetched as well.
+// A single chain of nodes still costs one memory latency per node,
+// and on short lists or cheap f the extra iterator is pure
+// overhead, so it is opt-in: iterator types specialize
+// node_prefetch_distance, or callers use for_each_prefetch.
+// Single-pass (input) iterators can't have a second iterator ahead.
+template <typename T>
+struct node_prefetch_distance : std::integral_constant<std::ptrdiff_t, 0> {};
+
+template <typename T>
+concept bool PrefetchedNodeIterator =
+    ForwardIterator<T> &&
+    !IteratorCategoryAtLeast<T, std::random_access_iterator_tag> &&
+    ( node_prefetch_distance<T>::value > 0 );
+
+template <std::ptrdiff_t Distance,
+          ForwardIterator Iter,
+          Callable<void,
+              typename std::iterator_traits<Iter>::reference>
+          Func>
+void for_each_prefetch( Iter first, Iter last, Func f )
+{
+    Iter ahead = first;
+    for ( std::ptrdiff_t n = 0; n < Distance && ahead != last; ++n )
+        ++ahead;
+    for (; ahead != last; ++first, ++ahead ) {
+        __builtin_prefetch( std::addressof( *ahead ) );
+        if constexpr ( std::is_pointer_v<
+                typename std::iterator_traits<Iter>::value_type > )
+            __builtin_prefetch( *ahead );
+        f( *first );
+    }
+    for (; first != last; ++first )
+        f( *first );
+}
+
+template <PrefetchedNodeIterator Iter,
+          Callable<void,
+              typename std::iterator_traits<Iter>::reference>
+          Func>
+void for_each( Iter first, Iter last, Func f )
+{
+    for_each_prefetch<node_prefetch_distance<Iter>::value>(
+        first, last, f );
+}
+
+// The minimal string of a range, compared as min above compares
+// two. Returns the first of the equal minimal elements.
+template <ForwardIterator Iter>
+    requires CharString<typename std::iterator_traits<Iter>::value_type>
+Iter min_element(Iter first, Iter last)
+{
+    if ( first == last ) return last;
+    // The best string is in registers, and a new one is taken with a
+    // branch. g++ would rather select it with cmov, but then every
+    // compare waits on the one before it to learn which string it is
+    // against, which made wide strings slower than std::min_element;
+    // the empty asm statement keeps the branch.
+    Iter best = first;
+    auto data = first->data();
+    std::size_t size = first->size();
+    for ( ++first; first != last; ++first ) {
+        if ( simd_string_detail::less(first->data(), first->size(),
+                                      data, size) ) {
+            __asm__ volatile ( "" );
+            best = first;
+            data = first->data();
+            size = first->size();
+        }
+    }
+    return best;
+}
+
+// Projections: comp and f are handed proj(element) rather than the
+// element, so a key is named once (&MyData::n, or a callable) instead
+// of being recomputed on both sides of a hand-written comparator.
+// Pointers to members are applied as std::invoke would apply them,
+// without <functional>.
+template <typename P, typename T>
+concept bool Projection =
+    ( MemObjPointer<P> &&
+      requires (P p, T&& x) { std::forward<T>(x).*p; } ) ||
+    ( MemFuncPointer<P> &&
+      requires (P p, T&& x) { (std::forward<T>(x).*p)(); } ) ||
+    Callable<P, void, T>;
+
+namespace projection_detail {
+    template <typename P, typename T>
+    constexpr decltype(auto) project(P& proj, T&& x)
+    {
+        if constexpr ( MemObjPointer<P> )
+            return ( std::forward<T>(x).*proj );
+        else if constexpr ( MemFuncPointer<P> )
+            return ( std::forward<T>(x).*proj )();
+        else
+            return proj( std::forward<T>(x) );
+    }
+}
+
+// What proj(x) is, and the key it denotes with references and cv
+// stripped.
+template <typename P, typename T>
+using projected_ref_t = decltype( projection_detail::project(
+    std::declval<P&>(), std::declval<T>() ) );
+template <typename P, typename T>
+using projected_t = std::remove_cv_t<std::remove_reference_t<
+    projected_ref_t<P, T>>>;
+
+// Wrapping a projection in cache_keys asks the min below to compute
+// each element's key once and keep the best key so far, instead of
+// projecting both sides of every comparison: n keys rather than
+// 2(n-1). The price is materializing each key, so only expensive
+// keys gain; &MyData::n without it never copies an int.
+template <typename P>
+struct cached_projection {
+    P proj;
+
+    template <typename T> requires Projection<const P, T>
+    constexpr decltype(auto) operator()(T&& x) const
+    { return projection_detail::project( proj, std::forward<T>(x) ); }
+};
+
+template <typename P>
+constexpr cached_projection<P> cache_keys(P proj) { return { proj }; }
+
+template <typename P>
+constexpr bool is_cached_projection = false;
+template <typename P>
+constexpr bool is_cached_projection<cached_projection<P>> = true;
+
+// The first element with the least key; last for an empty range.
+template <ForwardIterator Iter, typename Compare, typename Proj>
+    requires Projection<Proj,
+                 typename std::iterator_traits<Iter>::reference> &&
+             Callable<Compare, bool,
+                 const projected_t<Proj,
+                     typename std::iterator_traits<Iter>::reference>&,
+                 const projected_t<Proj,
+                     typename std::iterator_traits<Iter>::reference>&>
+Iter min_element(Iter first, Iter last, Compare comp, Proj proj)
+{
+    using projection_detail::project;
+    if ( first == last ) return last;
+    Iter best = first;
+    if constexpr ( is_cached_projection<Proj> ) {
+        using Key = projected_t<Proj,
+            typename std::iterator_traits<Iter>::reference>;
+        Key best_key = project( proj.proj, *first );
+        for ( ++first; first != last; ++first ) {
+            Key key = project( proj.proj, *first );
+            if ( comp( key, best_key ) ) {
+                best_key = std::move( key );
+                best = first;
+            }
+        }
+    } else {
+        for ( ++first; first != last; ++first )
+            if ( comp( project( proj, *first ), project( proj, *best ) ) )
+                best = first;
+    }
+    return best;
+}
+
+template <typename R>
+concept bool Range =
+    requires (R& r) {
+        std::begin(r);
+        requires SameType<decltype(std::begin(r)), decltype(std::end(r))>;
+    };
+
+template <Range R>
+using range_iterator_t = decltype( std::begin( std::declval<R&>() ) );
+
+// Like ranges::min, by value, since range may be a temporary. range
+// must not be empty.
+template <Range R, typename Compare, typename Proj>
+    requires ForwardIterator<range_iterator_t<R>> &&
+             requires (Compare comp, Proj proj, range_iterator_t<R> i) {
+                 min_element(i, i, comp, proj);
+             }
+constexpr typename std::iterator_traits<range_iterator_t<R>>::value_type
+min(R&& range, Compare comp, Proj proj)
+{
+    return *min_element( std::begin(range), std::end(range), comp, proj );
+}
+
+template <typename T, typename Compare, typename Proj>
+    requires requires (Compare comp, Proj proj, const T* p) {
+        min_element(p, p, comp, proj);
+    }
+constexpr T min(std::initializer_list<T> il, Compare comp, Proj proj)
+{
+    return *min_element( il.begin(), il.end(), comp, proj );
+}
+
+template <InputIterator Iter, typename Func, typename Proj>
+    requires Projection<Proj,
+                 typename std::iterator_traits<Iter>::reference> &&
+             Callable<Func, void, projected_ref_t<Proj,
+                 typename std::iterator_traits<Iter>::reference>>
+void for_each( Iter first, Iter last, Func f, Proj proj )
+{
+    for (; first != last; ++first )
+        f( projection_detail::project( proj, *first ) );
+}
+
+// A structure of arrays: one std::vector per listed member of
+// Record, given as pointers to data members, as in
+// soa_vector<MyData, &MyData::n, &MyData::z>. A pass that touches one
+// or two fields of a wide record then reads only their columns
+// instead of whole records. Elements are read back as Records by
+// assigning the listed members of a value-initialized one.
+namespace soa_detail {
+    template <auto A, auto B>
+    struct same_member : std::false_type {};
+    template <auto A>
+    struct same_member<A, A> : std::true_type {};
+
+    template <auto M, auto... Members>
+    constexpr std::size_t index_of()
+    {
+        constexpr bool hit[] = { same_member<M, Members>::value... };
+        for ( std::size_t i = 0; i < sizeof...(Members); ++i )
+            if ( hit[i] ) return i;
+        return sizeof...(Members);
+    }
+
+    template <typename T>
+    struct member_traits;
+    template <typename C, typename T>
+    struct member_traits<T C::*> {
+        using record = C;
+        using type = T;
+    };
+}
+
+// What *it is for an soa_iterator: the element's position, read as a
+// whole Record by converting, or a field at a time by get<M>().
+template <typename Vector>
+class soa_reference {
+public:
+    using record = typename Vector::value_type;
+
+    soa_reference(Vector& v, std::size_t i) : v_(&v), i_(i) {}
+
+    template <auto M>
+    decltype(auto) get() const
+    { return v_->template column<M>()[i_]; }
+
+    operator record() const { return v_->load(i_); }
+
+private:
+    Vector* v_;
+    std::size_t i_;
+};
+
+// Single-pass, since its reference is a proxy rather than a
+// value_type&. operator-> hands out a copy of the element, which
+// lives until the end of the full expression.
+template <typename Vector>
+class soa_iterator {
+public:
+    class arrow;
+
+    using iterator_category = std::input_iterator_tag;
+    using value_type = typename Vector::value_type;
+    using reference = soa_reference<Vector>;
+    using pointer = arrow;
+    using difference_type = std::ptrdiff_t;
+
+    class arrow {
+    public:
+        explicit arrow(value_type r) : r_(std::move(r)) {}
+        value_type* operator->() { return std::addressof(r_); }
+    private:
+        value_type r_;
+    };
+
+    soa_iterator() = default;
+    soa_iterator(Vector& v, std::size_t i) : v_(&v), i_(i) {}
+
+    reference operator*() const { return { *v_, i_ }; }
+    arrow operator->() const { return arrow(**this); }
+    soa_iterator& operator++() { ++i_; return *this; }
+    soa_iterator operator++(int) { soa_iterator old = *this; ++i_; return old; }
+
+    friend bool operator==(const soa_iterator& a, const soa_iterator& b)
+    { return a.i_ == b.i_; }
+    friend bool operator!=(const soa_iterator& a, const soa_iterator& b)
+    { return !(a == b); }
+
+    Vector& container() const { return *v_; }
+    std::size_t index() const { return i_; }
+
+private:
+    Vector* v_ = nullptr;
+    std::size_t i_ = 0;
+};
+
+template <typename Record, auto... Members>
+class soa_vector {
+    static_assert( ( SameType<typename soa_detail::member_traits<
+                         decltype(Members)>::record, Record> && ... ),
+                   "every column must be a data member of Record" );
+
+    template <auto M>
+    static constexpr std::size_t index = soa_detail::index_of<M, Members...>();
+
+public:
+    using value_type = Record;
+    using iterator = soa_iterator<soa_vector>;
+    using const_iterator = soa_iterator<const soa_vector>;
+
+    std::size_t size() const { return std::get<0>(columns_).size(); }
+    bool empty() const { return size() == 0; }
+    void reserve(std::size_t n) { ( column<Members>().reserve(n), ... ); }
+
+    void push_back(const Record& r)
+    { ( column<Members>().push_back(r.*Members), ... ); }
+
+    Record load(std::size_t i) const
+    {
+        Record r{};
+        ( ( r.*Members = column<Members>()[i] ), ... );
+        return r;
+    }
+
+    template <auto M>
+    auto& column()
+    {
+        static_assert( index<M> < sizeof...(Members), "not a column" );
+        return std::get<index<M>>(columns_);
+    }
+    template <auto M>
+    const auto& column() const
+    {
+        static_assert( index<M> < sizeof...(Members), "not a column" );
+        return std::get<index<M>>(columns_);
+    }
+
+    iterator begin() { return { *this, 0 }; }
+    iterator end() { return { *this, size() }; }
+    const_iterator begin() const { return { *this, 0 }; }
+    const_iterator end() const { return { *this, size() }; }
+
+    soa_reference<soa_vector> operator[](std::size_t i)
+    { return { *this, i }; }
+    soa_reference<const soa_vector> operator[](std::size_t i) const
+    { return { *this, i }; }
+
+private:
+    std::tuple<std::vector<
+        typename soa_detail::member_traits<decltype(Members)>::type>...>
+        columns_;
+};
+
+template <typename Vector, auto M>
+using soa_field_t = decltype(std::declval<soa_reference<Vector>>()
+                                 .template get<M>());
+
+// for_each<&R::a, &R::b>(first, last, f) calls f(a, b) for each
+// element, streaming only those two columns.
+template <auto... Fields, typename Vector, typename Func>
+    requires sizeof...(Fields) != 0 &&
+             Callable<Func, void, soa_field_t<Vector, Fields>...>
+void for_each( soa_iterator<Vector> first, soa_iterator<Vector> last,
+               Func f )
+{
+    const std::size_t n = last.index() - first.index();
+    auto run = [&f, n](auto*... column) {
+        for ( std::size_t i = 0; i < n; ++i )
+            f( column[i]... );
+    };
+    run( first.container().template column<Fields>().data() +
+         first.index()... );
+}
+
+// The first element of [first, last) whose Field is minimal, found
+// from that column alone. Arithmetic and string columns go through
+// the min_elements above, so NaN fields are skipped as they are
+// there.
+template <auto Field, typename Vector>
+soa_iterator<Vector> min_element( soa_iterator<Vector> first,
+                                  soa_iterator<Vector> last )
+{
+    if ( first == last ) return last;
+    const auto* column =
+        first.container().template column<Field>().data();
+    const auto* b = column + first.index();
+    const auto* e = column + last.index();
+    using T = std::remove_cv_t<std::remove_pointer_t<decltype(b)>>;
+    const T* best = b;
+    if constexpr ( Arithmetic<T> || CharString<T> ) {
+        best = min_element(b, e);
+    } else {
+        for ( const T* p = b + 1; p != e; ++p )
+            if ( *p < *best ) best = p;
+    }
+    return { first.container(), std::size_t(best - column) };
+}
+
+// A running minimum shared between threads, without a lock:
+// fetch_min(a, v) stores v in a if v < a, and returns what a held, as
+// atomic<T>::fetch_add does for +. A v that wouldn't improve on a
+// costs one load and never takes a's cache line for writing, which
+// once the minimum settles is nearly every call. As with min(a, b), a
+// NaN never displaces a number, but one already stored stays.
+namespace atomic_min_detail {
+    // The ordering a load standing in for the read half of a
+    // read-modify-write may have.
+    constexpr std::memory_order load_order(std::memory_order order)
+    {
+        return order == std::memory_order_release ? std::memory_order_relaxed
+             : order == std::memory_order_acq_rel ? std::memory_order_acquire
+             : order;
+    }
+
+    // Threads take shards round robin, in the order they first ask.
+    inline unsigned thread_slot()
+    {
+        static std::atomic<unsigned> next{ 0 };
+        thread_local const unsigned slot =
+            next.fetch_add(1, std::memory_order_relaxed);
+        return slot;
+    }
+}
+
+template <Scalar T> requires LessComparable<T>
+T fetch_min(std::atomic<T>& a, typename std::atomic<T>::value_type v,
+            std::memory_order order = std::memory_order_seq_cst)
+{
+    const std::memory_order failure = atomic_min_detail::load_order(order);
+    T old = a.load(failure);
+    while ( v < old )
+        if ( a.compare_exchange_weak(old, v, order, failure) ) break;
+    return old;
+}
+
+// Whether v became a's new minimum.
+template <Scalar T> requires LessComparable<T>
+bool atomic_min(std::atomic<T>& a, typename std::atomic<T>::value_type v,
+                std::memory_order order = std::memory_order_seq_cst)
+{
+    return v < fetch_min(a, v, order);
+}
+
+// fetch_min spread over Shards cache lines, for when so many threads
+// improve the minimum at once that they queue for a single line. Each
+// thread updates its own shard, and the shards are merged only when
+// the minimum is read, so a read costs Shards loads.
+template <Scalar T, std::size_t Shards = 16> requires LessComparable<T>
+class sharded_min {
+public:
+    explicit sharded_min(T initial)
+    {
+        for ( shard& s : shards_ )
+            s.value.store(initial, std::memory_order_relaxed);
+    }
+    // Starts above every value: infinity, or T's maximum.
+    sharded_min() requires Arithmetic<T>
+        : sharded_min( std::numeric_limits<T>::has_infinity
+                       ? std::numeric_limits<T>::infinity()
+                       : std::numeric_limits<T>::max() ) {}
+
+    // Whether v improved this thread's shard, which needn't mean it
+    // is the minimum overall.
+    bool update(T v, std::memory_order order = std::memory_order_seq_cst)
+    {
+        return atomic_min(
+            shards_[atomic_min_detail::thread_slot() % Shards].value, v,
+            order );
+    }
+
+    T load(std::memory_order order = std::memory_order_seq_cst) const
+    {
+        T m = shards_[0].value.load(order);
+        for ( std::size_t i = 1; i < Shards; ++i ) {
+            const T x = shards_[i].value.load(order);
+            if ( x < m ) m = x;
+        }
+        return m;
+    }
+
+private:
+    // 64 rather than hardware_destructive_interference_size, which
+    // g++ warns may differ between translation units.
+    struct alignas(64) shard { std::atomic<T> value; };
+    shard shards_[Shards];
+};
+
 ///////////////
 
 struct MyData { int n; double z; };
@@ -433,6 +1398,7 @@ int main() {
     min(2, 5, greater_int);
     min(d1, d2, my_greater);
     min( { 1, 5, -2, 10 } );
+    min( { 0.5, -0.0, 0.0, 2.5 } );
     min( { d1, d2, d3 } );
     min( { 1, 5, -2, 10 }, greater_int );
     min( { d1, d3, d2 }, my_greater );
@@ -440,10 +1406,22 @@ int main() {
     int iarr[] = { 1, 5, -2, 10 };
     auto do_int = [](int& n) { ++n; };
     for_each(std::begin(iarr), std::end(iarr), do_int);
+    min_element(std::begin(iarr), std::end(iarr));
     const MyData darr[] = { d1, d2, { -5, 3.0 } };
     auto do_data = [](const MyData&) {};
     for_each(std::begin(darr), std::end(darr), do_data);
     for_each(MyIter{}, MyIter{}, do_data);
-}
 
+    soa_vector<MyData, &MyData::n, &MyData::z> dsoa;
+    for ( const MyData& d : darr ) dsoa.push_back(d);
+    static_assert( InputIterator<decltype(dsoa.begin())> );
+    for_each(dsoa.begin(), dsoa.end(), do_data);
+    for_each<&MyData::n>(dsoa.begin(), dsoa.end(), do_int);
+    min_element<&MyData::z>(dsoa.begin(), dsoa.end());
 
+    min( { d1, d2, d3 }, greater_int, &MyData::n );
+    min( darr, [](double x, double y) { return x<y; }, &MyData::z );
+    for_each(std::begin(iarr), std::end(iarr), do_int,
+             [](int& n) -> int& { return n; });
+    for_each(std::begin(darr), std::end(darr), [](int) {}, &MyData::n);
+}
@@ -13,27 +13,76 @@ Implement:
 */
 
 #include <iterator>
+#include <string_view>
 #include <type_traits>
+#include <utility>
 
 template <typename T, typename U>
-concept bool LessThanEqualityComparable = requires(T a, U b) 
+concept bool LessThanComparable = requires(const T& a, const U& b) 
 {
- { a <= b } -> bool;
+ { b < a } -> bool;
 };
 
-// I sense there's more nuance to this:
+// What ?: makes of two const lvalues: an lvalue only when both bind to
+// it without a temporary (same type, or base and derived), a prvalue
+// when a conversion is needed.
 template <typename T, typename U>
-requires LessThanEqualityComparable<T, U>
-auto min(const T& a, const U& b)
+using common_ref_t = decltype(false ? std::declval<const std::decay_t<T>&>()
+                                    : std::declval<const std::decay_t<U>&>());
+
+// min can hand back one of its arguments itself only when both are
+// lvalues and share a reference type. An rvalue argument is a
+// temporary that dies at the end of the caller's full-expression, so
+// a reference to it would dangle in `const auto& m = min(f(), x);`.
+// Returning by value in that case makes the dangling binding
+// impossible instead of merely diagnosable; the temporary is moved,
+// not copied.
+template <typename T, typename U>
+concept bool ReferenceMin = std::is_lvalue_reference_v<T> &&
+                            std::is_lvalue_reference_v<U> &&
+                            std::is_lvalue_reference_v<common_ref_t<T, U>>;
+
+template <typename T, typename U>
+struct min_result { using type = std::common_type_t<T, U>; };
+
+template <typename T, typename U>
+requires ReferenceMin<T, U>
+struct min_result<T, U> { using type = common_ref_t<T, U>; };
+
+// Returns a on ties, as std::min does.
+template <typename T, typename U>
+requires LessThanComparable<T, U>
+constexpr typename min_result<T, U>::type min(T&& a, U&& b)
 {
- return a <= b ? a : b;
+ if (b < a)
+  return std::forward<U>(b);
+ return std::forward<T>(a);
+}
+
+// String literals and other char pointers compare by address under <,
+// so min("hi", "there") used to pick whichever the linker placed
+// first. These compare the characters instead and return a view of
+// the smaller string. The pointers must be non-null and terminated.
+template <typename T>
+concept bool CharPointer = std::is_same_v<std::decay_t<T>, const char*> ||
+                           std::is_same_v<std::decay_t<T>, char*>;
+
+template <typename T, typename U>
+requires LessThanComparable<T, U> && CharPointer<T> && CharPointer<U>
+constexpr std::string_view min(T&& a, U&& b)
+{
+ std::string_view x(a), y(b);
+ return y < x ? y : x;
 }
 
 ////
 
+// Every category that refines forward (bidirectional, random access)
+// is derived from its tag, so vector and list iterators qualify too.
 template <typename IterT>
 concept bool ForwardIterator = 
-    std::is_same_v<std::forward_iterator_tag, typename IterT::iterator_category>;
+    std::is_base_of_v<std::forward_iterator_tag,
+                      typename std::iterator_traits<IterT>::iterator_category>;
 
 template <typename ValueT, typename FnT>
 concept bool UnaryCallable = requires(ValueT a, FnT f)
@@ -43,7 +92,8 @@ concept bool UnaryCallable = requires(ValueT a, FnT f)
 
 template <typename IteratorT, typename CallableT>
 requires ForwardIterator<IteratorT> && 
-         UnaryCallable<typename IteratorT::value_type, CallableT>
+         UnaryCallable<typename std::iterator_traits<IteratorT>::value_type,
+                       CallableT>
 auto for_each(IteratorT b, IteratorT e, CallableT f)
 {
  for(; e != b; ++b)
@@ -54,8 +104,76 @@ auto for_each(IteratorT b, IteratorT e, CallableT f)
 
 ////
 
+#include <chrono>
 #include <iostream>
 #include <forward_list>
+#include <string>
+#include <vector>
+
+namespace min_tests {
+struct base { int n; bool operator<(const base& o) const { return n < o.n; } };
+struct derived : base {};
+
+int i = 0;
+long l = 0;
+std::string s;
+base b;
+derived d;
+
+static_assert(std::is_same_v<decltype(min(i, i)), const int&>);
+static_assert(std::is_same_v<decltype(min(s, s)), const std::string&>);
+static_assert(std::is_same_v<decltype(min(b, d)), const base&>);
+// Mixed types need a conversion, so a common_type value.
+static_assert(std::is_same_v<decltype(min(i, l)), long>);
+static_assert(std::is_same_v<decltype(min(s, "x")), std::string>);
+// A temporary is never referred to past the call.
+static_assert(std::is_same_v<decltype(min(std::string(), s)), std::string>);
+static_assert(std::is_same_v<decltype(min(1, 2)), int>);
+static_assert(std::is_same_v<decltype(min("hi", "there")), std::string_view>);
+
+constexpr int one = 1, two = 2;
+static_assert(&min(one, two) == &one);
+static_assert(&min(one, one) == &one, "ties go to the first argument");
+}
+
+// Running minimum over long strings: the old min returned auto and so
+// copied (and allocated) the winner at every step.
+void min_bench()
+{
+ std::vector<std::string> words;
+ for(int k = 0; k < 100000; ++k)
+  words.push_back(std::string(48, 'a' + k % 26) + std::to_string(k * 7919 % 100000));
+
+ auto ns_per_word = [&](auto run) {
+  double best = 1e300;
+  for(int trial = 0; trial < 5; ++trial) {
+   auto start = std::chrono::steady_clock::now();
+   run();
+   std::chrono::duration<double, std::nano> took = std::chrono::steady_clock::now() - start;
+   best = std::min(best, took.count());
+  }
+  return best / words.size();
+ };
+
+ std::size_t sink = 0;
+ double by_value = ns_per_word([&] {
+  auto copying_min = [](const std::string& a, const std::string& b) { return b < a ? b : a; };
+  std::string m = words[0];
+  for(const auto& w : words)
+   m = copying_min(m, w);
+  sink += m.size();
+ });
+ double by_reference = ns_per_word([&] {
+  const std::string* m = &words[0];
+  for(const auto& w : words)
+   m = &min(*m, w);
+  sink += m->size();
+ });
+ std::cout << "\nns/word, " << words.size() << " strings of 50+ chars\n"
+           << " returning auto:      " << by_value << '\n'
+           << " returning reference: " << by_reference << '\n'
+           << (sink ? "" : " ");
+}
 
 int main()
 {
@@ -78,5 +196,7 @@ int main()
  forward_list<int> xs { 1, 2, 3, 4, 5 };
  for_each(begin(xs), end(xs), 
           [](const auto& x) { cout << x << '\n'; }); 
+
+ min_bench();
 }
 
@@ -3,22 +3,29 @@
 #include <initializer_list>
 #include <iostream>
 #include <string>
+#include <cstddef>
+#include <iterator>
+#include <utility>
 
 template<typename T>
 concept bool LessThanComparable = requires(const T& a) {
-    { a < a } -> bool
+    { a < a } -> bool;
 };
 
 template<typename Param, typename Comp>
 concept bool ComparableVia = requires(const Comp& comp, const Param& a) {
-    { comp(a, a) } -> bool
+    { comp(a, a) } -> bool;
 };
 
 template<typename T>
 concept bool CopyConstructible = requires(T obj) {
-    { T { obj } } ->  T
+    { T { obj } } ->  T;
 };
 
+template<typename IT>
+concept bool RandomAccessIterator = std::is_base_of_v<
+    std::random_access_iterator_tag, typename std::iterator_traits<IT>::iterator_category>;
+
 template<typename T>
 requires LessThanComparable<T>
 constexpr const T& min(const T& a, const T& b) { return b < a ? b : a; }
@@ -44,11 +51,256 @@ constexpr T min(std::initializer_list<T> values, Comp compare)
     return *std::min_element(values.begin(), values.end(), compare);
 }
 
+// minmax / minmax_element in one pass: the first smallest and the last
+// largest element win, like std.
+
+template<typename IT, typename Comp>
+constexpr std::pair<IT, IT> pairwise_minmax(IT first, IT last, Comp compare)
+{
+    // Order each pair with one comparison, then only test the smaller
+    // one against the min and the larger one against the max:
+    // 3 comparisons per 2 elements.
+    auto lo = first, hi = first;
+    if(first == last || ++first == last) return { lo, hi };
+    for(; first != last; ++first) {
+        auto it = first;
+        if(++first == last) {
+            if(compare(*it, *lo)) lo = it;
+            else if(!compare(*it, *hi)) hi = it;
+            break;
+        }
+        if(compare(*first, *it)) {
+            if(compare(*first, *lo)) lo = first;
+            if(!compare(*it, *hi)) hi = it;
+        } else {
+            if(compare(*it, *lo)) lo = it;
+            if(!compare(*first, *hi)) hi = first;
+        }
+    }
+    return { lo, hi };
+}
+
+template<typename T>
+constexpr std::pair<const T*, const T*> lanes_minmax(const T* first, const T* last)
+{
+    // A block of independent running minimums/maximums that g++ turns
+    // into packed min/max instructions, then a short search for where
+    // they are. A NaN makes < unordered and the search may fail; the
+    // pairwise loop's answer is as good as any then. A NaN seeding a
+    // lane would hide that whole lane, so the first block must have
+    // none.
+    constexpr std::ptrdiff_t width = 64 / sizeof(T);
+    auto less = [](const T& a, const T& b) { return a < b; };
+    if(last - first < 2 * width) return pairwise_minmax(first, last, less);
+
+    T lo[width] = {}, hi[width] = {};
+    for(std::ptrdiff_t k = 0; k < width; ++k) {
+        if(!(first[k] == first[k])) return pairwise_minmax(first, last, less);
+        lo[k] = hi[k] = first[k];
+    }
+    auto block = first + width;
+    for(; last - block >= width; block += width) {
+        for(std::ptrdiff_t k = 0; k < width; ++k) {
+            lo[k] = block[k] < lo[k] ? block[k] : lo[k];
+            hi[k] = hi[k] < block[k] ? block[k] : hi[k];
+        }
+    }
+    T min = lo[0], max = hi[0];
+    for(std::ptrdiff_t k = 1; k < width; ++k) {
+        min = lo[k] < min ? lo[k] : min;
+        max = max < hi[k] ? hi[k] : max;
+    }
+    for(; block != last; ++block) {
+        min = *block < min ? *block : min;
+        max = max < *block ? *block : max;
+    }
+
+    auto min_at = first;
+    while(min_at != last && !(*min_at == min)) ++min_at;
+    auto max_at = last;
+    while(max_at != first && !(max_at[-1] == max)) --max_at;
+    if(min_at == last || max_at == first) return pairwise_minmax(first, last, less);
+    return { min_at, max_at - 1 };
+}
+
+template<typename T>
+requires LessThanComparable<T>
+constexpr std::pair<const T&, const T&> minmax(const T& a, const T& b)
+{
+    if(b < a) return { b, a };
+    return { a, b };
+}
+
+template<typename T, typename Comp>
+requires ComparableVia<T, Comp> && CopyConstructible<Comp> && CopyConstructible<T>
+constexpr std::pair<const T&, const T&> minmax(const T& a, const T& b, Comp compare)
+{
+    if(compare(b, a)) return { b, a };
+    return { a, b };
+}
+
+template<typename IT>
+requires LessThanComparable<typename std::iterator_traits<IT>::value_type>
+constexpr std::pair<IT, IT> minmax_element(IT first, IT last)
+{
+    using T = typename std::iterator_traits<IT>::value_type;
+    if constexpr(std::is_pointer_v<IT> && std::is_arithmetic_v<T>) {
+        auto [lo, hi] = lanes_minmax<T>(first, last);
+        return { first + (lo - first), first + (hi - first) };
+    } else {
+        return pairwise_minmax(first, last, [](const T& a, const T& b) { return a < b; });
+    }
+}
+
+template<typename IT, typename Comp>
+requires ComparableVia<typename std::iterator_traits<IT>::value_type, Comp> && CopyConstructible<Comp>
+constexpr std::pair<IT, IT> minmax_element(IT first, IT last, Comp compare)
+{
+    return pairwise_minmax(first, last, compare);
+}
+
+template<typename T>
+requires CopyConstructible<T> && LessThanComparable<T>
+constexpr std::pair<T, T> minmax(std::initializer_list<T> values)
+{
+    auto [lo, hi] = ::minmax_element(values.begin(), values.end());
+    return { *lo, *hi };
+}
+
+template<typename T, typename Comp>
+requires CopyConstructible<T> && ComparableVia<T, Comp> && CopyConstructible<Comp>
+constexpr std::pair<T, T> minmax(std::initializer_list<T> values, Comp compare)
+{
+    auto [lo, hi] = ::minmax_element(values.begin(), values.end(), compare);
+    return { *lo, *hi };
+}
+
+// Positions of the first smallest / first largest value.
+template<typename T>
+requires LessThanComparable<T>
+constexpr std::size_t argmin(std::initializer_list<T> values)
+{
+    return std::min_element(values.begin(), values.end()) - values.begin();
+}
+
+template<typename T, typename Comp>
+requires ComparableVia<T, Comp> && CopyConstructible<Comp>
+constexpr std::size_t argmin(std::initializer_list<T> values, Comp compare)
+{
+    return std::min_element(values.begin(), values.end(), compare) - values.begin();
+}
+
+template<typename T>
+requires LessThanComparable<T>
+constexpr std::size_t argmax(std::initializer_list<T> values)
+{
+    return std::max_element(values.begin(), values.end()) - values.begin();
+}
+
+template<typename T, typename Comp>
+requires ComparableVia<T, Comp> && CopyConstructible<Comp>
+constexpr std::size_t argmax(std::initializer_list<T> values, Comp compare)
+{
+    return std::max_element(values.begin(), values.end(), compare) - values.begin();
+}
+
+template<typename Range>
+using range_value_t = std::decay_t<decltype(*std::begin(std::declval<const Range&>()))>;
+
+template<typename IT, typename OutIT, typename Comp>
+OutIT min_k_heap(IT first, IT last, std::size_t k, OutIT out, Comp compare)
+{
+    // A max-heap of the best k so far: anything not smaller than its
+    // top is rejected with a single comparison.
+    auto end = out;
+    for(; first != last && std::size_t(end - out) < k; ++first, ++end) *end = *first;
+    std::make_heap(out, end, compare);
+    for(; first != last; ++first) {
+        if(compare(*first, *out)) {
+            std::pop_heap(out, end, compare);
+            end[-1] = *first;
+            std::push_heap(out, end, compare);
+        }
+    }
+    std::sort_heap(out, end, compare);
+    return end;
+}
+
+template<typename IT, typename OutIT, typename Comp>
+OutIT min_k_partition(IT first, IT last, std::size_t k, OutIT out, Comp compare)
+{
+    // Collect candidates into 2k slots; whenever they fill up, keep the
+    // k smallest and make the k-th the bar the next ones must pass.
+    // Each round costs O(k) and rounds get rarer as the bar drops.
+    auto kth = out + (k - 1);
+    auto end = out;
+    bool have_bar = false;
+    auto full = out + 2 * k;
+    for(; first != last; ++first) {
+        if(have_bar && !compare(*first, *kth)) continue;
+        *end = *first;
+        if(++end == full) {
+            std::nth_element(out, kth, end, compare);
+            end = kth + 1;
+            have_bar = true;
+        }
+    }
+    if(std::size_t(end - out) > k) {
+        std::nth_element(out, kth, end, compare);
+        end = kth + 1;
+    }
+    std::sort(out, end, compare);
+    return end;
+}
+
+// Below this the heap wins anyway: few values ever get past its top.
+inline constexpr std::size_t min_k_heap_limit = 256;
+
+// The k smallest values, smallest first, without sorting everything
+// and without allocating: the caller's output range is the only
+// storage. k is clamped to its size, so a short range gets the
+// smallest values that fit; given room for 2k, a large k uses the
+// partition path instead of the heap. Returns the end of what
+// was written.
+template<typename Range, typename OutIT, typename Comp>
+requires CopyConstructible<range_value_t<Range>> && ComparableVia<range_value_t<Range>, Comp> && CopyConstructible<Comp> && RandomAccessIterator<OutIT>
+OutIT min_k(const Range& values, std::size_t k, OutIT out_first, OutIT out_last, Comp compare)
+{
+    auto capacity = std::size_t(out_last - out_first);
+    k = std::min(k, capacity);
+    if(k == 0) return out_first;
+    if(k > min_k_heap_limit && capacity >= 2 * k)
+        return min_k_partition(std::begin(values), std::end(values), k, out_first, compare);
+    return min_k_heap(std::begin(values), std::end(values), k, out_first, compare);
+}
+
+template<typename Range, typename OutIT>
+requires CopyConstructible<range_value_t<Range>> && LessThanComparable<range_value_t<Range>> && RandomAccessIterator<OutIT>
+OutIT min_k(const Range& values, std::size_t k, OutIT out_first, OutIT out_last)
+{
+    return min_k(values, k, out_first, out_last, std::less<>{});
+}
+
+// Braced lists don't deduce as a Range.
+template<typename T, typename OutIT, typename Comp>
+requires CopyConstructible<T> && ComparableVia<T, Comp> && CopyConstructible<Comp> && RandomAccessIterator<OutIT>
+OutIT min_k(std::initializer_list<T> values, std::size_t k, OutIT out_first, OutIT out_last, Comp compare)
+{
+    return min_k<std::initializer_list<T>>(values, k, out_first, out_last, compare);
+}
+
+template<typename T, typename OutIT>
+requires CopyConstructible<T> && LessThanComparable<T> && RandomAccessIterator<OutIT>
+OutIT min_k(std::initializer_list<T> values, std::size_t k, OutIT out_first, OutIT out_last)
+{
+    return min_k<std::initializer_list<T>>(values, k, out_first, out_last, std::less<>{});
+}
+
 
 template<typename T>
 concept bool InputIterator = requires(T it) {
-    { ++it } -> T
-    { *it } /* This should return a value, but I don't know the type just from T */
+    { ++it } -> T;
+    { *it }; /* This should return a value, but I don't know the type just from T */
     /* { it->sometn() }  I should be able to reasonably use operator-> on it */
 };
 
@@ -67,10 +319,55 @@ Func for_each(IT first, IT last, Func func)
     return func;
 }
 
+#include <cassert>
+#include <chrono>
+#include <limits>
+#include <random>
+#include <vector>
+
+// Throughput of min_k against what it replaces: copy + sort + truncate.
+void min_k_bench()
+{
+    std::mt19937_64 rng(42);
+    std::uniform_real_distribution<double> dist(0, 1e6);
+    std::vector<double> latencies(1000000);
+    for(auto& v : latencies) v = dist(rng);
+
+    auto items_per_us = [&](auto run) {
+        double best = 1e300;
+        for(int trial = 0; trial < 5; ++trial) {
+            auto start = std::chrono::steady_clock::now();
+            run();
+            std::chrono::duration<double, std::micro> took = std::chrono::steady_clock::now() - start;
+            best = std::min(best, took.count());
+        }
+        return latencies.size() / best;
+    };
+
+    std::cout << "\nM items/s, " << latencies.size() << " doubles\n"
+              << "        k  sort+truncate  min_k (k slots)  min_k (2k slots)\n";
+    for(std::size_t k : { 10, 100, 1000, 10000, 100000 }) {
+        std::vector<double> out(2 * k);
+        double sorted = items_per_us([&] {
+            std::vector<double> copy(latencies);
+            std::sort(copy.begin(), copy.end());
+            copy.resize(k);
+            std::copy(copy.begin(), copy.end(), out.begin());
+        });
+        double heap = items_per_us([&] { min_k(latencies, k, out.begin(), out.begin() + k); });
+        double partition = items_per_us([&] { min_k(latencies, k, out.begin(), out.end()); });
+        std::cout << std::string(9 - std::to_string(k).size(), ' ') << k
+                  << "  " << sorted << "  " << heap << "  " << partition << '\n';
+    }
+}
+
 int main() {
     auto numbers = { 1, 2, 3, 4, 5 };
     std::cout << "min(numbers): " << min(numbers);
     std::cout << "\nmin(4, 3): " << min(4, 3);
+    auto [lo, hi] = minmax(numbers);
+    std::cout << "\nminmax(numbers): " << lo << ' ' << hi;
+    std::cout << "\nargmax(numbers): " << argmax(numbers);
     std::cout << "\nnumbers:\n";
 
     // gcc 7.2 segfaulted for some reason at the next statement
@@ -80,5 +377,30 @@ int main() {
 
     // this fails because int is not an InputIterator
     // for_each(1, 3, [](auto n) { std::cout << n << '\n'; });
+
+    int smallest[3];
+    auto end = min_k(numbers, 3, smallest, smallest + 3, [](int a, int b) { return a > b; });
+    std::cout << "largest 3:";
+    for_each(smallest, end, [](int n) { std::cout << ' ' << n; });
+
+    // k larger than the output range: only what fits is written.
+    int two[3] = { 0, 0, -1 };
+    end = min_k(numbers, 5, two, two + 2);
+    assert(end == two + 2 && two[0] == 1 && two[1] == 2 && two[2] == -1);
+    end = min_k(numbers, 5, two, two);
+    assert(end == two && two[2] == -1);
+    // The output is sorted and heaped in place, so it must be random access.
+    static_assert(!RandomAccessIterator<std::ostream_iterator<int>>);
+
+    // A NaN seeding a lane other than the first must not hide the
+    // values that lane sees later.
+    double v[256];
+    std::fill(v, v + 256, 1.0);
+    v[3] = std::numeric_limits<double>::quiet_NaN();
+    v[163] = -5;
+    auto [vlo, vhi] = minmax_element(v, v + 256);
+    assert(vlo == v + 163 && *vhi == 1.0);
+
+    min_k_bench();
 }
 
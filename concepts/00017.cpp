@@ -1,6 +1,12 @@
 // Using concepts syntax of your choice:
 #include<algorithm>
+#include<array>
+#include<cstddef>
 #include<functional>
+#include<iterator>
+#include<tuple>
+#include<type_traits>
+#include<utility>
 #include<vector>
 
 #define Forward(x) std::forward<decltype(x)>(x)
@@ -20,7 +26,8 @@ using pointed_type = decltype(*std::declval<T>());
 template<class T>
 concept bool Iterator = requires(T&& v)
   {
-  {*Forward(v)}->const auto&;//not void
+  *Forward(v);
+  requires !std::is_void_v<decltype(*Forward(v))>;
   {++v}-> T&;
   {v!=v}-> bool;
   };
@@ -74,7 +81,196 @@ constexpr for_each(T beg, T end, auto f)
   return f;
   }
 
-    
+// Reimplement std::for_each over the elements of one fixed-size
+// object: anything tuple-like (std::tuple, std::pair, std::array, or
+// a type with tuple_size and get), a built-in array, or an aggregate
+// struct of up to 8 members that aren't themselves arrays. The calls
+// are unrolled by pack expansion, so there is no loop counter, and
+// each element's type picks its own overload of f at compile time
+// (overloaded below builds such an f out of lambdas). Homogeneous
+// objects with more than unroll_limit elements are looped over.
 
+template<class...F>
+struct overloaded : F...
+  {
+  using F::operator()...;
+  };
+template<class...F>
+overloaded(F...) -> overloaded<F...>;
+
+namespace for_each_detail
+  {
+  template<class T>
+  using bare = std::remove_cv_t<std::remove_reference_t<T>>;
+
+  constexpr std::size_t unroll_limit=16;
+
+  // Converts to any member type, to count an aggregate's members by
+  // how many of it can brace-initialize one. Never defined.
+  struct any_field
+    {
+    template<class T>
+    constexpr operator T() const;
+    };
+
+  template<class T,std::size_t...I>
+  constexpr bool
+  brace_initializable(std::index_sequence<I...>)
+    {
+    return requires { T{(void(I),any_field{})...}; };
+    }
+
+  constexpr std::size_t max_fields=8;
+
+  template<class T,std::size_t N=max_fields>
+  constexpr std::size_t
+  counted_fields()
+    {
+    if constexpr(N==0 || brace_initializable<T>(std::make_index_sequence<N>{}))
+      return N;
+    else
+      return counted_fields<T,N-1>();
+    }
+
+  // 0 past max_fields: max_fields initializers would brace-initialize
+  // a bigger aggregate too, and binding it would then fail.
+  template<class T>
+  constexpr std::size_t
+  field_count()
+    {
+    if constexpr(brace_initializable<T>(std::make_index_sequence<max_fields+1>{}))
+      return 0;
+    else
+      return counted_fields<T>();
+    }
 
+  template<class T,std::size_t...I>
+  constexpr decltype(auto)
+  apply_indexed(T&& t,auto&& v,std::index_sequence<I...>)
+    {
+    using std::get;
+    if constexpr(std::is_array_v<std::remove_reference_t<T>>)
+      return v(t[I]...);
+    else
+      return v(get<I>(Forward(t))...);
+    }
+
+  // The members, as lvalues of the record's constness.
+  constexpr decltype(auto)
+  apply_fields(auto& r,auto&& v)
+    {
+    constexpr auto n=field_count<bare<decltype(r)>>();
+    if constexpr(n==1){auto& [a]=r; return v(a);}
+    else if constexpr(n==2){auto& [a,b]=r; return v(a,b);}
+    else if constexpr(n==3){auto& [a,b,c]=r; return v(a,b,c);}
+    else if constexpr(n==4){auto& [a,b,c,d]=r; return v(a,b,c,d);}
+    else if constexpr(n==5){auto& [a,b,c,d,e]=r; return v(a,b,c,d,e);}
+    else if constexpr(n==6){auto& [a,b,c,d,e,f]=r; return v(a,b,c,d,e,f);}
+    else if constexpr(n==7){auto& [a,b,c,d,e,f,g]=r; return v(a,b,c,d,e,f,g);}
+    else {auto& [a,b,c,d,e,f,g,h]=r; return v(a,b,c,d,e,f,g,h);}
+    }
+  }
+
+template<class T>
+concept bool TupleLike = requires
+  {
+  std::tuple_size<std::remove_reference_t<T>>::value;
+  };
+
+template<class T>
+concept bool FixedArray = std::is_array_v<std::remove_reference_t<T>> &&
+  std::extent_v<std::remove_reference_t<T>> != 0;
+
+template<class T>
+concept bool Record = std::is_aggregate_v<for_each_detail::bare<T>> &&
+  std::is_class_v<for_each_detail::bare<T>> && !TupleLike<T> &&
+  for_each_detail::field_count<for_each_detail::bare<T>>() != 0;
 
+template<class T>
+concept bool FixedSize = TupleLike<T> || FixedArray<T> || Record<T>;
+
+// How many elements an unrolled call would make; 0 for a Record,
+// which always unrolls.
+template<class T>
+constexpr std::size_t
+element_count()
+  {
+  if constexpr(TupleLike<T>)
+    return std::tuple_size<std::remove_reference_t<T>>::value;
+  else if constexpr(FixedArray<T>)
+    return std::extent_v<std::remove_reference_t<T>>;
+  else
+    return 0;
+  }
+
+FixedSize{T}
+constexpr auto
+for_each(T&& t, auto f)
+  {
+  constexpr auto n=element_count<T>();
+  if constexpr(n>for_each_detail::unroll_limit &&
+               requires { std::begin(t); })
+    {
+    for(auto i=std::begin(t);i!=std::end(t);++i)
+      f(*i);
+    }
+  else if constexpr(Record<T>)
+    for_each_detail::apply_fields(t,[&f](auto&...e)
+      {
+      (f(e),...);
+      });
+  else
+    for_each_detail::apply_indexed(Forward(t),[&f](auto&&...e)
+      {
+      (f(Forward(e)),...);
+      },std::make_index_sequence<n>{});
+  return f;
+  }
+
+// Checks, run at compile time.
+namespace for_each_checks
+  {
+  constexpr long
+  sum(auto&& t)
+    {
+    long s=0;
+    for_each(Forward(t),[&s](auto e){s+=e;});
+    return s;
+    }
+
+  // How many elements f was handed as rvalues.
+  constexpr int
+  rvalues(auto&& t)
+    {
+    int n=0;
+    for_each(Forward(t),[&n](auto&& e){n+=std::is_rvalue_reference_v<decltype(e)>;});
+    return n;
+    }
+
+  constexpr std::tuple<int,long,unsigned> tuple{1,2,3};
+  static_assert(sum(tuple)==6);
+  static_assert(rvalues(tuple)==0);
+  static_assert(rvalues(std::tuple<int,long,unsigned>{1,2,3})==3);
+
+  static_assert(sum(std::array<int,4>{1,2,3,4})==10);
+  // Past unroll_limit, the loop.
+  static_assert(sum(std::array<int,20>{1,2,3,4,5,6,7,8,9,10,11,12,13,14,15,16,17,18,19,20})==210);
+
+  constexpr int builtin[]={1,2,3};
+  static_assert(sum(builtin)==6);
+
+  struct eight{int a,b,c,d,e,f,g,h;};
+  struct nine{int a,b,c,d,e,f,g,h,i;};
+  static_assert(sum(eight{1,2,3,4,5,6,7,8})==36);
+  static_assert(Record<const eight&> && !Record<nine> && !FixedSize<nine>);
+
+  // Each element's type picks its overload.
+  constexpr int
+  ints_minus_doubles()
+    {
+    int n=0;
+    for_each(std::tuple{1,2.0,3,4.0f},overloaded{[&n](int){++n;},[&n](auto){--n;}});
+    return n;
+    }
+  static_assert(ints_minus_doubles()==0);
+  }
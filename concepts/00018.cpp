@@ -5,6 +5,7 @@
 //  - it is unintuitive which requirements need to be written for specific situation
 //      - as if you need to write standard proposal-like "standardese"
 
+#include <cstddef>
 #include <functional>
 #include <iterator>
 
@@ -22,7 +23,7 @@ namespace concepts {
 template<typename T>
 concept bool PredicateResult = requires (T t) {
     t? 1 : 1; // can be used in "if"
-    {(bool) t} // can direct initialize bool
+    {(bool) t}; // can direct initialize bool
 };
 
 // Variadic predicate
@@ -50,37 +51,45 @@ concept bool Value = std::is_copy_constructible_v<T>
    && std::is_move_assignable_v<T>
    && std::is_destructible_v<T>;
 
-template<Value Pred, typename... Args>
-concept bool PredicateValue = Predicate<Pred, Args...>;
+// Current g++ refuses constrained parameters on a variable concept,
+// so the constraints below are spelled as conjunctions instead.
+template<typename Pred, typename... Args>
+concept bool PredicateValue = Value<Pred> && Predicate<Pred, Args...>;
 
 template<class T, class U>
 concept bool Exactly = std::is_same<T, U>::value;
 
-template<Value T>
-concept bool Iterator = requires (T i) {
+template<typename T>
+concept bool Iterator = Value<T> && requires (T i) {
     typename std::iterator_traits<T>::iterator_category;
     { ++i } -> Exactly<T&>;
     { *i } -> Exactly<typename std::iterator_traits<T>::reference>;
     { *i } -> typename std::iterator_traits<T>::value_type;
 };
 
-template<Iterator It, typename Tag>
-concept bool IteratorAtLeast = std::is_base_of_v<Tag, typename std::iterator_traits<It>::iterator_category>;
+template<typename It, typename Tag>
+concept bool IteratorAtLeast = Iterator<It> && std::is_base_of_v<Tag, typename std::iterator_traits<It>::iterator_category>;
 
-template<typename Tag, IteratorAtLeast<Tag> Start, Value End>
-concept bool DenoteRange = requires(Start s, End e) {
+template<typename Tag, typename Start, typename End>
+concept bool DenoteRange = IteratorAtLeast<Start, Tag> && Value<End> && requires(Start s, End e) {
     { s != e } -> PredicateResult;
     { s == e } -> PredicateResult;
 };
 
-template<IteratorAtLeast<std::input_iterator_tag> Start, Value End>
-concept bool DenoteInputRange = requires(Start s, End e) {
+template<typename Start, typename End>
+concept bool DenoteInputRange = IteratorAtLeast<Start, std::input_iterator_tag> && Value<End> && requires(Start s, End e) {
     { s != e } -> PredicateResult;
     { s == e } -> PredicateResult;
 };
 
-template<Value F, typename Arg>
-concept bool UnaryFunctionValue = Callable<F, Arg>;
+// Not Value<F>: no capturing lambda is copy assignable, and
+// for_each only ever moves its function object.
+template<typename F, typename Arg>
+concept bool UnaryFunctionValue = std::is_move_constructible_v<F> && Callable<F, Arg>;
+
+// A UnaryFunctionValue whose result says whether to go on.
+template<typename F, typename Arg>
+concept bool UnaryPredicateValue = std::is_move_constructible_v<F> && Predicate<F, Arg>;
 
 }
 
@@ -106,20 +115,130 @@ constexpr const T& min(const T& a, const T& b, concepts::PredicateValue<T, T> co
 template<typename It>
 using reference_t = typename std::iterator_traits<It>::reference;
 
+template<typename It>
+using difference_t = typename std::iterator_traits<It>::difference_type;
+
+// End of a range given by its length instead of a position:
+// for_each(first, counted_sentinel{n}, f) visits [first, first + n).
+// Deliberately not comparable with iterators, so it never matches
+// DenoteRange and always gets the down-counting loop.
+template<typename Difference = std::ptrdiff_t>
+struct counted_sentinel {
+    Difference count;
+};
+template<typename Difference>
+counted_sentinel(Difference) -> counted_sentinel<Difference>;
+
+// End of a range that never ends, e.g. one that is known to contain
+// a terminator the callable stops at (by throwing). Compares unequal
+// to everything, so it also works with any DenoteRange algorithm.
+// Two of them don't compare: with It left open, both operand orders
+// would match and the call would be ambiguous.
+struct unreachable_sentinel_t {
+    template<typename It> requires !std::is_same_v<It, unreachable_sentinel_t>
+    friend constexpr bool operator==(const It&, unreachable_sentinel_t) { return false; }
+    template<typename It> requires !std::is_same_v<It, unreachable_sentinel_t>
+    friend constexpr bool operator==(unreachable_sentinel_t, const It&) { return false; }
+    template<typename It> requires !std::is_same_v<It, unreachable_sentinel_t>
+    friend constexpr bool operator!=(const It&, unreachable_sentinel_t) { return true; }
+    template<typename It> requires !std::is_same_v<It, unreachable_sentinel_t>
+    friend constexpr bool operator!=(unreachable_sentinel_t, const It&) { return true; }
+};
+inline constexpr unreachable_sentinel_t unreachable_sentinel{};
+
+static_assert(!(0 == unreachable_sentinel) && unreachable_sentinel != 0);
+static_assert(concepts::DenoteRange<std::random_access_iterator_tag, int*, unreachable_sentinel_t>);
+
 // Reimplement std::for_each
 
 // Unfortunatly following code cannot be used:
 // concepts::DenoteRange<std::input_iterator_tag>{InputIt, Sentinel}
 
 namespace foo {
+
+namespace detail {
+// A single down-counter and no end compare: the loop shape compilers
+// vectorize and unroll best.
+template<typename InputIt, typename F>
+InputIt counted_loop( InputIt first, difference_t<InputIt> n, F& f ) {
+    for(; n > 0; --n, ++first) {
+        f(*first);
+    }
+    return first;
+}
+}
+
 template<typename InputIt, typename Sentinel, concepts::UnaryFunctionValue<typename std::iterator_traits<InputIt>::reference> F>
 requires concepts::DenoteRange<std::input_iterator_tag, InputIt, Sentinel>
 F for_each( InputIt first, Sentinel last, F f ) {
-    for(; first != last; ++first) {
-        f(*first);
+    // A random access range knows its length up front.
+    if constexpr(concepts::IteratorAtLeast<InputIt, std::random_access_iterator_tag>
+                 && std::is_same_v<InputIt, Sentinel>) {
+        detail::counted_loop(first, last - first, f);
+    } else {
+        for(; first != last; ++first) {
+            f(*first);
+        }
     }
     return std::move(f);
 }
+
+template<typename InputIt, typename Difference, concepts::UnaryFunctionValue<typename std::iterator_traits<InputIt>::reference> F>
+requires concepts::IteratorAtLeast<InputIt, std::input_iterator_tag>
+F for_each( InputIt first, counted_sentinel<Difference> last, F f ) {
+    detail::counted_loop(first, difference_t<InputIt>(last.count), f);
+    return f;
+}
+
+template<typename InputIt, concepts::UnaryFunctionValue<typename std::iterator_traits<InputIt>::reference> F>
+requires concepts::IteratorAtLeast<InputIt, std::input_iterator_tag>
+F for_each( InputIt first, unreachable_sentinel_t, F f ) {
+    for(;; ++first) {
+        f(*first);
+    }
+}
+
+// As std::for_each_n: returns the iterator past the last element visited.
+template<typename InputIt, typename Size, concepts::UnaryFunctionValue<typename std::iterator_traits<InputIt>::reference> F>
+requires concepts::IteratorAtLeast<InputIt, std::input_iterator_tag> && std::is_integral_v<Size>
+InputIt for_each_n( InputIt first, Size n, F f ) {
+    return detail::counted_loop(first, difference_t<InputIt>(n), f);
+}
+
+// Early exit: visits elements while f returns true and stops at the
+// first one it returns false for, e.g. a validation pass that ends at
+// the first bad record. Returns that element's position, or the end
+// of the range if f accepted everything.
+template<typename InputIt, typename Sentinel, concepts::UnaryPredicateValue<typename std::iterator_traits<InputIt>::reference> F>
+requires concepts::DenoteRange<std::input_iterator_tag, InputIt, Sentinel>
+InputIt for_each_while( InputIt first, Sentinel last, F f ) {
+    for(; first != last; ++first) {
+        if(!bool(f(*first))) {
+            break;
+        }
+    }
+    return first;
+}
+
+template<typename InputIt, typename Difference, concepts::UnaryPredicateValue<typename std::iterator_traits<InputIt>::reference> F>
+requires concepts::IteratorAtLeast<InputIt, std::input_iterator_tag>
+InputIt for_each_while( InputIt first, counted_sentinel<Difference> last, F f ) {
+    for(auto n = difference_t<InputIt>(last.count); n > 0; --n, ++first) {
+        if(!bool(f(*first))) {
+            break;
+        }
+    }
+    return first;
+}
+
+// The converse: stops at the first element f returns true for.
+template<typename InputIt, typename Sentinel, concepts::UnaryPredicateValue<typename std::iterator_traits<InputIt>::reference> F>
+requires requires(InputIt i, Sentinel s, F f) { foo::for_each_while(i, s, f); }
+InputIt for_each_until( InputIt first, Sentinel last, F f ) {
+    return foo::for_each_while(first, last, [&f](reference_t<InputIt> x) {
+        return !bool(f(std::forward<reference_t<InputIt>>(x)));
+    });
+}
 }
 
 namespace foo1 {
@@ -148,6 +267,18 @@ UnaryFunctionFor<InputIt> for_each( InputIt first, Sentinel last, UnaryFunctionF
     }
     return std::move(f);
 }
+
+// counted_sentinel isn't a DenoteInputRange, and unreachable_sentinel
+// shouldn't pay for the compare; both share foo's loops.
+template<concepts::IteratorAtLeast<std::input_iterator_tag> InputIt, typename Difference>
+UnaryFunctionFor<InputIt> for_each( InputIt first, counted_sentinel<Difference> last, UnaryFunctionFor<InputIt> f ) {
+    return foo::for_each(first, last, std::move(f));
+}
+
+template<concepts::IteratorAtLeast<std::input_iterator_tag> InputIt>
+UnaryFunctionFor<InputIt> for_each( InputIt first, unreachable_sentinel_t last, UnaryFunctionFor<InputIt> f ) {
+    return foo::for_each(first, last, std::move(f));
+}
 }
 
 #include <vector>
@@ -161,6 +292,35 @@ int test51() {
     return res;
 }
 
+int test52() {
+    std::vector<int> a {1, 2, 3, 4};
+    int res = 0;
+    auto add = [&](const int& a){ res += a; };
+    foo::for_each(a.begin(), counted_sentinel{3}, add);            // 1 + 2 + 3
+    foo2::for_each(a.data(), counted_sentinel{std::size_t{2}}, add); // 1 + 2
+    auto next = foo::for_each_n(a.begin(), 2u, add);                   // 1 + 2
+    try {
+        foo::for_each(next, unreachable_sentinel, [&](const int& a){
+            if(a == 4) throw a;
+            res += a;                                                  // 3
+        });
+    } catch(int) {}
+    return res; // 15
+}
+
+int test53() {
+    std::vector<int> a {1, 2, 3, -1, 5};
+    int res = 0;
+    auto valid = [&](const int& a){ res += a; return a > 0; };
+    auto bad = foo::for_each_while(a.begin(), a.end(), valid);      // 1 + 2 + 3 - 1
+    foo::for_each_while(a.begin(), counted_sentinel{2}, valid);     // 1 + 2
+    // A terminator ends the walk without throwing, unlike test52.
+    auto four = foo::for_each_until(a.begin(), unreachable_sentinel, [](const int& a){
+        return a == 5;
+    });
+    return res + int(bad - a.begin()) + int(four - a.begin()); // 8 + 3 + 4
+}
+
 // Testing
 
 struct explicit_bool_conv {
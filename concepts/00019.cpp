@@ -1,5 +1,18 @@
+#include <algorithm>
+#include <cassert>
+#include <coroutine>
+#include <cstddef>
+#include <exception>
+#include <iterator>
+#include <list>
+#include <memory>
+#include <span>
+#include <type_traits>
+#include <utility>
 #include <vector>
 
+// Needs C++20 for std::span and coroutines: g++ -std=c++20 -fconcepts-ts
+
 // Using concepts syntax of your choice:
 // Reimplement std::min
 template<typename T>
@@ -78,6 +91,304 @@ OP for_each(IT start, IT end, OP f) {
     return f;
 }
 
+// Batched for_each
+// Some callables (writing into an I/O buffer, inserting into a hash
+// table) are far cheaper per element when they get many at once. One
+// that takes a std::span but not a single element gets chunks: slices
+// of the range itself when it is contiguous, otherwise copies that are
+// collected in a buffer and flushed when it is full (so it has to take
+// a span of const). Anything callable with one element, generic
+// lambdas included, is never even tried with a span and keeps the
+// one-call-per-element loop above; wrap it in batched() to get chunks.
+
+template<typename IT>
+using element_t = std::remove_reference_t<decltype(*std::declval<IT&>())>;
+
+template<typename IT>
+using batch_t = std::conditional_t<std::contiguous_iterator<IT>,
+                                   element_t<IT>,
+                                   const std::remove_cv_t<element_t<IT>>>;
+
+template<typename OP, typename IT>
+concept bool element_callable = requires (IT it, OP op) { op(*it); };
+
+template<typename OP, typename IT>
+concept bool batch_callable = !element_callable<OP, IT> &&
+    requires (OP op, std::span<batch_t<IT>> s) { op(s); };
+
+// About half of an L1 data cache per chunk.
+inline constexpr std::size_t batch_bytes = 16 * 1024;
+
+// Hands op spans only; chunk fixes the number of elements per call.
+template<class OP>
+struct batched {
+    OP op;
+    std::size_t chunk = 0;
+
+    template<typename T>
+    auto operator()(std::span<T> s) { return op(s); }
+};
+template<class OP> batched(OP) -> batched<OP>;
+template<class OP> batched(OP, std::size_t) -> batched<OP>;
+
+template<typename T, class OP>
+std::size_t chunk_elements(const OP &) {
+    return std::max<std::size_t>(1, batch_bytes / sizeof(T));
+}
+
+template<typename T, class OP>
+std::size_t chunk_elements(const batched<OP> & f) {
+    return f.chunk ? f.chunk : chunk_elements<T>(f.op);
+}
+
+template<fwd_iterator IT, class OP>
+requires batch_callable<OP, IT>
+OP for_each(IT start, IT end, OP f) {
+    using T = batch_t<IT>;
+    const std::size_t chunk = chunk_elements<T>(f);
+    if constexpr (std::contiguous_iterator<IT>) {
+        auto data = std::to_address(start);
+        auto left = static_cast<std::size_t>(end - start);
+        while(left > 0) {
+            auto n = std::min(chunk, left);
+            f(std::span<T>(data, n));
+            data += n;
+            left -= n;
+        }
+    } else {
+        std::vector<std::remove_const_t<T>> buffer;
+        buffer.reserve(chunk);
+        while(start != end) {
+            buffer.push_back(*start);
+            ++start;
+            if(buffer.size() == chunk) {
+                f(std::span<T>(buffer));
+                buffer.clear();
+            }
+        }
+        if(!buffer.empty()) {
+            f(std::span<T>(buffer));
+        }
+    }
+    return f;
+}
+
+// Interleaved for_each
+// When the callable itself chases pointers (a hash table lookup keyed
+// by the element, say), prefetching the next element doesn't help:
+// the misses are inside the callable. So let the callable be a
+// coroutine that co_awaits prefetch(p) right before it would touch p.
+// for_each_interleaved keeps G of them in flight and resumes them
+// round-robin, so by the time one comes back to p, the line has had
+// G - 1 other lookups' worth of time to arrive.
+//
+//   for_each_interleaved<16>(keys.begin(), keys.end(),
+//       [&](int key) -> interleaved_task {
+//           auto * bucket = &table[hash(key)];
+//           co_await prefetch(bucket);
+//           ...
+//       });
+//
+// The plain for_each above would just create and drop the tasks;
+// interleaved_task is [[nodiscard]] so that gets a warning.
+
+struct prefetch {
+    const void * address;
+
+    bool await_ready() const noexcept { return false; }
+    void await_suspend(std::coroutine_handle<>) const noexcept {
+        __builtin_prefetch(address);
+    }
+    void await_resume() const noexcept {}
+};
+
+// Coroutine frames freed by this thread, for reuse. Frames of
+// different coroutines have different sizes, so take() looks for one
+// of the size asked for; and at most max_frames are kept, the rest go
+// back to the heap, so the list can't grow without bound.
+struct frame_free_list_t {
+    struct frame {
+        frame * next;
+        std::size_t size;
+    };
+    // A few for_each_interleaved calls' worth of slots.
+    static constexpr std::size_t max_frames = 64;
+    frame * head = nullptr;
+    std::size_t count = 0;
+
+    void * take(std::size_t size) {
+        for(frame ** link = &head; *link; link = &(*link)->next) {
+            if((*link)->size == size) {
+                --count;
+                return std::exchange(*link, (*link)->next);
+            }
+        }
+        return nullptr;
+    }
+
+    void give(void * f, std::size_t size) {
+        if(count == max_frames) {
+            ::operator delete(f, size);
+            return;
+        }
+        ++count;
+        head = ::new(f) frame{head, size};
+    }
+
+    ~frame_free_list_t() {
+        while(head) {
+            auto * f = std::exchange(head, head->next);
+            ::operator delete(f, f->size);
+        }
+    }
+};
+inline thread_local frame_free_list_t frame_free_list;
+
+class [[nodiscard]] interleaved_task {
+public:
+    struct promise_type {
+        interleaved_task get_return_object() {
+            return interleaved_task{std::coroutine_handle<promise_type>::from_promise(*this)};
+        }
+        std::suspend_always initial_suspend() noexcept { return {}; }
+        std::suspend_always final_suspend() noexcept { return {}; }
+        void return_void() {}
+        void unhandled_exception() { throw; }
+
+        // Every element gets a frame of the same size, so reuse the
+        // ones this thread freed instead of going back to the heap.
+        static void * operator new(std::size_t size) {
+            if(void * frame = frame_free_list.take(size)) {
+                return frame;
+            }
+            return ::operator new(size);
+        }
+        static void operator delete(void * frame, std::size_t size) {
+            frame_free_list.give(frame, size);
+        }
+    };
+
+    interleaved_task() = default;
+    interleaved_task(interleaved_task && other) noexcept
+        : handle_(std::exchange(other.handle_, {})) {}
+    interleaved_task & operator=(interleaved_task && other) noexcept {
+        std::swap(handle_, other.handle_);
+        return *this;
+    }
+    ~interleaved_task() { if(handle_) handle_.destroy(); }
+
+    // Empty, or ran to completion.
+    bool done() const { return !handle_ || handle_.done(); }
+
+    void resume() {
+        handle_.resume();
+    }
+
+private:
+    explicit interleaved_task(std::coroutine_handle<promise_type> handle) : handle_(handle) {}
+    std::coroutine_handle<promise_type> handle_;
+};
+
+template<typename OP, typename IT>
+concept bool interleaved_callable = requires (IT it, OP op) {
+    { op(*it) } -> interleaved_task;
+};
+
+// G is how many lookups are in flight; about as many as the core has
+// outstanding-miss slots (10-20 on current x86) is a good start.
+template<std::size_t G = 16, fwd_iterator IT, class OP>
+requires interleaved_callable<OP, IT>
+OP for_each_interleaved(IT start, IT end, OP f) {
+    interleaved_task slots[G];
+    for(bool running = true; running; ) {
+        running = false;
+        for(auto & slot : slots) {
+            if(slot.done()) {
+                if(start == end) {
+                    continue;
+                }
+                slot = f(*start);
+                ++start;
+            }
+            slot.resume();
+            running = true;
+        }
+    }
+    return f;
+}
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <random>
+
+// Probing a chained hash table much bigger than the caches, once per
+// key: the plain loop waits out every miss, the interleaved one
+// overlaps them.
+void interleaved_bench() {
+    struct node {
+        std::uint64_t key, value;
+        node * next;
+    };
+    const std::size_t buckets = std::size_t(1) << 21;
+    const std::size_t entries = 2 * buckets;
+    std::mt19937_64 rng(7);
+
+    // Shuffle the nodes so that chains don't follow allocation order.
+    std::vector<node> nodes(entries);
+    for(auto & n : nodes) n = { rng(), rng() % 100, nullptr };
+    std::vector<node *> order(entries);
+    for(std::size_t i = 0; i < entries; ++i) order[i] = &nodes[i];
+    std::shuffle(order.begin(), order.end(), rng);
+    std::vector<node *> table(buckets, nullptr);
+    auto bucket_of = [&](std::uint64_t key) { return (key * 0x9E3779B97F4A7C15u) >> 43; };
+    for(auto * n : order) {
+        auto & head = table[bucket_of(n->key)];
+        n->next = head;
+        head = n;
+    }
+
+    std::vector<std::uint64_t> keys(4 * buckets);
+    for(auto & k : keys) k = rng() % 2 ? nodes[rng() % entries].key : rng();
+
+    std::uint64_t found = 0;
+    auto lookup = [&](std::uint64_t key) {
+        for(node * n = table[bucket_of(key)]; n; n = n->next) {
+            if(n->key == key) { found += n->value; return; }
+        }
+    };
+    auto lookup_interleaved = [&](std::uint64_t key) -> interleaved_task {
+        auto * head = &table[bucket_of(key)];
+        co_await prefetch{head};
+        for(node * n = *head; n; n = n->next) {
+            co_await prefetch{n};
+            if(n->key == key) { found += n->value; co_return; }
+        }
+    };
+
+    auto ns_per_key = [&](auto run) {
+        double best = 1e300;
+        for(int trial = 0; trial < 3; ++trial) {
+            auto start = std::chrono::steady_clock::now();
+            run();
+            std::chrono::duration<double, std::nano> took = std::chrono::steady_clock::now() - start;
+            best = std::min(best, took.count() / keys.size());
+        }
+        return best;
+    };
+    double plain = ns_per_key([&] { for_each(keys.begin(), keys.end(), lookup); });
+    std::printf("%zu lookups, %zu entries\nplain loop       %6.1f ns/key\n", keys.size(), entries, plain);
+    auto row = [&](const char * name, auto run) {
+        double t = ns_per_key(run);
+        std::printf("%-16s %6.1f ns/key  %.2fx\n", name, t, plain / t);
+    };
+    row("interleaved 4", [&] { for_each_interleaved<4>(keys.begin(), keys.end(), lookup_interleaved); });
+    row("interleaved 8", [&] { for_each_interleaved<8>(keys.begin(), keys.end(), lookup_interleaved); });
+    row("interleaved 16", [&] { for_each_interleaved<16>(keys.begin(), keys.end(), lookup_interleaved); });
+    row("interleaved 32", [&] { for_each_interleaved<32>(keys.begin(), keys.end(), lookup_interleaved); });
+    std::printf("(%llu)\n", (unsigned long long) found);
+}
+
 
 // Just some test cases for me.
 int main()
@@ -91,5 +402,34 @@ int main()
 
     int test_array[3] = {4, 5, 6};
     for_each(test_array, test_array + 3, add_one);
+
+    // Gets the whole vector (and then the list, copied) in one call
+    int sum = 0;
+    auto add_all = [&](std::span<const int> s) { for(int v : s) sum += v; };
+    for_each(test_vector.begin(), test_vector.end(), add_all);
+    std::list<int> test_list{4, 5, 6};
+    for_each(test_list.begin(), test_list.end(), add_all);
+
+    // Still one element per call, unless wrapped: then two per call
+    auto add_any = [&](auto v) { sum += v.size(); };
+    // for_each(test_vector.begin(), test_vector.end(), add_any); // Error: int has no size()
+    for_each(test_array, test_array + 3, batched{add_any, 2});
+
+    // Every element's coroutine runs to completion, interleaved
+    for_each_interleaved<2>(test_vector.begin(), test_vector.end(), [&](int &v) -> interleaved_task {
+        co_await prefetch{&v};
+        sum += v;
+    });
+
+    // A coroutine with a bigger frame: the free list finds frames of
+    // its size behind the smaller ones, and keeps at most max_frames.
+    for_each_interleaved<2>(test_vector.begin(), test_vector.end(), [&](int &v) -> interleaved_task {
+        int copies[32] = {v};
+        co_await prefetch{&v};
+        sum += copies[0];
+    });
+    assert(frame_free_list.count <= frame_free_list_t::max_frames);
+
+    interleaved_bench();
 }
 